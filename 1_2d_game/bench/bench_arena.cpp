@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory_resource>
+#include <vector>
+#include "frame_arena.hpp"
+#include "render_queue.hpp"
+
+// Per-tick scratch workloads built with malloc-backed std::vector and with std::pmr::vector on a
+// FrameArena. Each frame builds its containers from scratch and drops them, the way transient
+// per-tick data is used.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Keeps results observable so the compiler cannot drop the work
+volatile std::uint64_t sink = 0;
+
+constexpr int FRAMES = 2000;
+
+/// @brief Render commands for a frame of bullets, pushed one by one without reserve
+template <typename Vector> void buildRenderCommands(Vector &commands, int count) {
+    for (int i = 0; i < count; i++) {
+        commands.push_back({static_cast<std::uint64_t>(i), glm::vec2(static_cast<float>(i)), 0.03f,
+                            glm::vec3(1.0f), Primitive::SdfCircle, 10});
+    }
+    sink = sink + commands.size();
+}
+
+/// @brief Broadphase-style candidate lists: many small vectors, one per grid cell
+/// @details A pmr outer vector passes its resource on to the lists it emplaces.
+template <typename Lists> void buildCandidateLists(Lists &lists, int cells) {
+    for (int cell = 0; cell < cells; cell++) {
+        auto &list = lists.emplace_back();
+        for (int i = 0; i < (cell % 16) + 1; i++) {
+            list.push_back(cell + i);
+        }
+    }
+    sink = sink + lists.size();
+}
+
+template <typename F> double nanosecondsPerFrame(F &&frame) {
+    for (int i = 0; i < FRAMES / 10; i++) {
+        frame();
+    }
+    auto start = Clock::now();
+    for (int i = 0; i < FRAMES; i++) {
+        frame();
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / FRAMES;
+}
+
+void report(const char *workload, double heapNanoseconds, double arenaNanoseconds) {
+    std::printf("%-24s heap %9.1f us/frame  arena %9.1f us/frame  speedup %.2fx\n", workload,
+                heapNanoseconds / 1000.0, arenaNanoseconds / 1000.0,
+                heapNanoseconds / arenaNanoseconds);
+}
+
+} // namespace
+
+int main() {
+    FrameArena arena(1 << 20);
+
+    for (int count : {1000, 10000, 100000}) {
+        double heap = nanosecondsPerFrame([&] {
+            std::vector<RenderCommand> commands;
+            buildRenderCommands(commands, count);
+        });
+        double pooled = nanosecondsPerFrame([&] {
+            arena.reset();
+            std::pmr::vector<RenderCommand> commands(&arena);
+            buildRenderCommands(commands, count);
+        });
+        char name[32];
+        std::snprintf(name, sizeof(name), "render commands %d", count);
+        report(name, heap, pooled);
+    }
+
+    for (int cells : {256, 4096}) {
+        double heap = nanosecondsPerFrame([&] {
+            std::vector<std::vector<int>> lists;
+            buildCandidateLists(lists, cells);
+        });
+        double pooled = nanosecondsPerFrame([&] {
+            arena.reset();
+            std::pmr::vector<std::pmr::vector<int>> lists(&arena);
+            buildCandidateLists(lists, cells);
+        });
+        char name[32];
+        std::snprintf(name, sizeof(name), "candidate lists %d", cells);
+        report(name, heap, pooled);
+    }
+
+    std::printf("arena capacity after warm-up: %zu bytes\n", arena.capacity());
+    return 0;
+}
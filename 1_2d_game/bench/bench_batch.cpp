@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "batch_env.hpp"
+
+// Environment steps per second of BatchEnvironment with a random policy.
+//
+//   bench_batch [--envs N] [--steps N] [--threads N] [--bullets N]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+    std::size_t environments = 4096;
+    int steps = 2000;
+    unsigned threads = 0;
+    int bullets = 0;
+};
+
+bool parseOptions(int argc, char **argv, BenchOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--envs" && hasValue) {
+            options.environments = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--steps" && hasValue) {
+            options.steps = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--bullets" && hasValue) {
+            options.bullets = std::atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options.environments > 0 && options.steps > 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--envs N] [--steps N] [--threads N] [--bullets N]\n";
+        return 1;
+    }
+
+    BatchConfig config;
+    config.initialBullets = options.bullets;
+    BatchEnvironment environment(options.environments, config, options.threads);
+
+    // Random buttons, generated up front so the policy costs nothing inside the timed loop
+    constexpr int INPUT_PATTERNS = 64;
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> buttons(0, 31);
+    std::vector<std::uint8_t> inputs(options.environments * INPUT_PATTERNS);
+    for (std::uint8_t &input : inputs) {
+        input = static_cast<std::uint8_t>(buttons(random));
+    }
+
+    double rewardSum = 0.0;
+    std::uint64_t episodesEnded = 0;
+    auto start = Clock::now();
+    for (int step = 0; step < options.steps; step++) {
+        environment.step(&inputs[(step % INPUT_PATTERNS) * options.environments]);
+        for (std::size_t i = 0; i < environment.size(); i++) {
+            rewardSum += environment.rewards()[i];
+            episodesEnded += environment.done()[i];
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    double steps = static_cast<double>(options.environments) * options.steps;
+    std::printf("%zu envs x %d steps on %u threads: %.0f env steps/s (%.1f ns/step), "
+                "%llu episodes ended, mean reward %.4f\n",
+                options.environments, options.steps, environment.threadCount(), steps / seconds,
+                seconds * 1e9 / steps, static_cast<unsigned long long>(episodesEnded),
+                rewardSum / steps);
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include "collision.hpp"
+#include "game.hpp"
+
+// Microbenchmarks for collision.hpp on randomized, reproducible workloads.
+//
+// For every distribution and shape count, each shape is tested against a random partner shape
+// (a fixed permutation), sweeping the whole set repeatedly until enough tests were timed. The
+// access pattern therefore touches all N shapes, so large sets measure memory behaviour as well as
+// the intersection math. Results are written as JSON so runs can be diffed between commits.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief Keeps hit counts observable so the compiler cannot drop the tests
+volatile std::uint64_t sink = 0;
+
+/// @brief Shape extents used by the game's bullets
+constexpr float RADIUS = EnemyBullet::RADIUS;
+constexpr float SIZE = PlayerBullet::SIZE;
+
+struct BenchOptions {
+    std::size_t maxShapes = 1000000;
+    /// @brief Minimum number of intersection tests timed per benchmark
+    std::uint64_t minTests = 4000000;
+    std::string outputPath;
+};
+
+enum class Distribution { Uniform, Clustered, Ring };
+
+const char *distributionName(Distribution distribution) {
+    switch (distribution) {
+    case Distribution::Uniform:
+        return "uniform";
+    case Distribution::Clustered:
+        return "clustered";
+    case Distribution::Ring:
+        return "ring";
+    }
+    return "";
+}
+
+/// @brief Reproducible shape centers in the [-1, 1] world box
+std::vector<glm::vec2> generatePoints(Distribution distribution, std::size_t count,
+                                      std::uint32_t seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<glm::vec2> points(count);
+    switch (distribution) {
+    case Distribution::Uniform:
+        for (glm::vec2 &point : points) {
+            point = {unit(random), unit(random)};
+        }
+        break;
+    case Distribution::Clustered: {
+        // Bullet patterns: a few tight groups
+        constexpr int CLUSTERS = 16;
+        std::vector<glm::vec2> centers(CLUSTERS);
+        for (glm::vec2 &center : centers) {
+            center = {unit(random) * 0.8f, unit(random) * 0.8f};
+        }
+        std::normal_distribution<float> spread(0.0f, 0.05f);
+        for (std::size_t i = 0; i < count; i++) {
+            points[i] = centers[i % CLUSTERS] + glm::vec2(spread(random), spread(random));
+        }
+        break;
+    }
+    case Distribution::Ring: {
+        // A radial burst: every shape on a thin annulus around the boss
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        std::normal_distribution<float> thickness(0.8f, 0.02f);
+        for (glm::vec2 &point : points) {
+            float a = angle(random);
+            float r = thickness(random);
+            point = {r * std::cos(a), r * std::sin(a)};
+        }
+        break;
+    }
+    }
+    return points;
+}
+
+struct BenchResult {
+    std::string name;
+    Distribution distribution;
+    std::size_t shapes;
+    std::uint64_t tests;
+    std::uint64_t hits;
+    double seconds;
+};
+
+/// @brief Time test(i, partner[i]) over whole sweeps of the set until minTests is reached
+template <typename Test>
+BenchResult runBenchmark(const char *name, Distribution distribution,
+                         const std::vector<std::uint32_t> &partners, std::uint64_t minTests,
+                         Test &&test) {
+    std::size_t count = partners.size();
+    // Warm-up sweep, also brings the shapes into cache where they fit
+    std::uint64_t hits = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        hits += test(i, partners[i]) ? 1 : 0;
+    }
+
+    std::uint64_t sweeps = std::max<std::uint64_t>(1, (minTests + count - 1) / count);
+    hits = 0;
+    auto start = Clock::now();
+    for (std::uint64_t sweep = 0; sweep < sweeps; sweep++) {
+        for (std::size_t i = 0; i < count; i++) {
+            hits += test(i, partners[i]) ? 1 : 0;
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    sink = sink + hits;
+    return {name, distribution, count, sweeps * count, hits / sweeps, seconds};
+}
+
+void runDistribution(Distribution distribution, std::size_t count, const BenchOptions &options,
+                     std::vector<BenchResult> &results) {
+    auto seed = static_cast<std::uint32_t>(count * 31 + static_cast<int>(distribution));
+    std::vector<glm::vec2> points = generatePoints(distribution, count, seed);
+
+    std::vector<std::uint32_t> partners(count);
+    std::iota(partners.begin(), partners.end(), 0u);
+    std::shuffle(partners.begin(), partners.end(), std::mt19937(seed + 1));
+
+    std::vector<CollisionCircle> circles;
+    std::vector<CollisionRectangle> rects;
+    std::vector<EnemyBullet> enemyBullets;
+    std::vector<PlayerBullet> playerBullets;
+    circles.reserve(count);
+    rects.reserve(count);
+    enemyBullets.reserve(count);
+    playerBullets.reserve(count);
+    for (glm::vec2 point : points) {
+        circles.emplace_back(point, RADIUS);
+        rects.emplace_back(point - SIZE / 2.0f, point + SIZE / 2.0f);
+        enemyBullets.emplace_back(glm::vec2(1.0f, 0.0f), point, 0.001f, 0);
+        playerBullets.emplace_back(point, 0.001f, 0);
+    }
+
+    results.push_back(runBenchmark("circle_circle", distribution, partners, options.minTests,
+                                   [&](std::size_t a, std::size_t b) {
+                                       return circles[a].intersects(circles[b]);
+                                   }));
+    results.push_back(runBenchmark("circle_rect", distribution, partners, options.minTests,
+                                   [&](std::size_t a, std::size_t b) {
+                                       return circles[a].intersects(rects[b]);
+                                   }));
+    results.push_back(runBenchmark("rect_rect", distribution, partners, options.minTests,
+                                   [&](std::size_t a, std::size_t b) {
+                                       return rects[a].intersects(rects[b]);
+                                   }));
+    // detectCollision overload constrained by ShapeConcept
+    results.push_back(runBenchmark("detect_shapes", distribution, partners, options.minTests,
+                                   [&](std::size_t a, std::size_t b) {
+                                       return detectCollision(circles[a], rects[b]);
+                                   }));
+    // detectCollision overload constrained by CollidableObject: getShape + variant visit
+    results.push_back(runBenchmark("detect_objects", distribution, partners, options.minTests,
+                                   [&](std::size_t a, std::size_t b) {
+                                       return detectCollision(enemyBullets[a], playerBullets[b]);
+                                   }));
+}
+
+void writeJson(std::ostream &out, const std::vector<BenchResult> &results) {
+    out << "{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const BenchResult &result = results[i];
+        double tests = static_cast<double>(result.tests);
+        out << "    {\"name\": \"" << result.name << "\", \"distribution\": \""
+            << distributionName(result.distribution) << "\", \"shapes\": " << result.shapes
+            << ", \"tests\": " << result.tests << ", \"hits_per_sweep\": " << result.hits
+            << ", \"ns_per_test\": " << result.seconds * 1e9 / tests
+            << ", \"pairs_per_second\": " << tests / result.seconds << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+bool parseOptions(int argc, char **argv, BenchOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--max-shapes" && hasValue) {
+            options.maxShapes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--min-tests" && hasValue) {
+            options.minTests = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--out" && hasValue) {
+            options.outputPath = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return options.maxShapes > 0 && options.minTests > 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--max-shapes N] [--min-tests N] [--out FILE]\n";
+        return 1;
+    }
+
+    std::vector<BenchResult> results;
+    for (Distribution distribution :
+         {Distribution::Uniform, Distribution::Clustered, Distribution::Ring}) {
+        for (std::size_t count = 100; count <= options.maxShapes; count *= 10) {
+            runDistribution(distribution, count, options, results);
+            std::cerr << "[bench] " << distributionName(distribution) << ' ' << count
+                      << " shapes done\n";
+        }
+    }
+
+    if (options.outputPath.empty()) {
+        writeJson(std::cout, results);
+    } else {
+        std::ofstream out(options.outputPath);
+        writeJson(out, results);
+        if (!out) {
+            std::cerr << "Failed to write " << options.outputPath << '\n';
+            return 1;
+        }
+    }
+    return 0;
+}
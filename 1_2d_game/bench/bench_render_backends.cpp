@@ -0,0 +1,144 @@
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "game.hpp"
+#include "scenario.hpp"
+#include "scene_target.hpp"
+#include "stats.hpp"
+#include "utils.hpp"
+
+// Draws a seeded bullet field with every render backend in a compatibility-profile context and
+// compares each against the immediate-mode glBegin path: milliseconds per frame (with glFinish,
+// so GPU time counts) and the fraction of pixels that differ from its image. Shaders are not
+// built, so SDF circles fall back to circles in every backend, as they do on legacy contexts.
+//
+//   bench_render_backends [--bullets N] [--frames N]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int SIZE = 600;
+
+/// @brief Draw the queue once and wait for the GPU to finish it
+void drawFrame(const RenderQueue &queue, const RenderContext &context, GlStateCache &cache,
+               RenderBackend backend, LegacyRenderer &legacy) {
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    applyRenderContext(context, cache);
+    executeRenderQueue(queue, cache, backend, legacy);
+    glFinish();
+}
+
+std::vector<std::uint32_t> readFrame() {
+    std::vector<std::uint32_t> pixels(static_cast<std::size_t>(SIZE) * SIZE);
+    glReadPixels(0, 0, SIZE, SIZE, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
+
+/// @brief Fraction of pixels with a channel more than 2 levels apart
+double differingPixels(const std::vector<std::uint32_t> &a, const std::vector<std::uint32_t> &b) {
+    std::size_t differing = 0;
+    for (std::size_t i = 0; i < a.size(); i++) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            int channelA = static_cast<int>((a[i] >> shift) & 0xFF);
+            int channelB = static_cast<int>((b[i] >> shift) & 0xFF);
+            if (std::abs(channelA - channelB) > 2) {
+                differing++;
+                break;
+            }
+        }
+    }
+    return static_cast<double>(differing) / static_cast<double>(a.size());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int bullets = 10000;
+    int frames = 200;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--bullets" && i + 1 < argc) {
+            bullets = std::atoi(argv[++i]);
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frames = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    glutInit(&argc, argv);
+    glutInitContextVersion(3, 2);
+    glutInitContextProfile(GLUT_COMPATIBILITY_PROFILE);
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
+    glutInitWindowSize(SIZE, SIZE);
+    glutCreateWindow("bench_render_backends");
+    glutHideWindow();
+    if (glewInit() != GLEW_OK) {
+        std::fprintf(stderr, "GLEW initialization failed\n");
+        return 1;
+    }
+    GLint profile = 0;
+    glGetIntegerv(GL_CONTEXT_PROFILE_MASK, &profile);
+    std::printf("%s, %s, %s profile\n", glGetString(GL_RENDERER), glGetString(GL_VERSION),
+                (profile & GL_CONTEXT_COMPATIBILITY_PROFILE_BIT) != 0 ? "compatibility" : "core");
+
+    // The hidden window owns no pixels, so frames are drawn into an offscreen target
+    SceneTarget target;
+    if (!target.init(SIZE, SIZE)) {
+        std::fprintf(stderr, "Framebuffer objects are unavailable\n");
+        return 1;
+    }
+    target.begin(1.0f);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    GameState gameState(100, 500);
+    populateBulletField(gameState, bullets, bullets / 10, 451);
+    RenderQueue renderQueue;
+    RenderContext context(gameState.cameraOffset, renderQueue);
+    Stats stats;
+    submitGame(gameState, context, stats);
+    renderQueue.sort();
+    std::printf("%d bullets, %zu commands, %d frames\n\n", bullets, renderQueue.commands().size(),
+                frames);
+
+    GlStateCache cache;
+    LegacyRenderer legacy;
+    std::vector<std::uint32_t> reference;
+    double immediateMilliseconds = 0.0;
+    bool matched = true;
+    for (RenderBackend backend : {RenderBackend::Immediate, RenderBackend::DisplayLists,
+                                  RenderBackend::VertexArrays}) {
+        // The first frame compiles display lists and grows the vertex arrays
+        drawFrame(renderQueue, context, cache, backend, legacy);
+        auto start = Clock::now();
+        for (int frame = 0; frame < frames; frame++) {
+            drawFrame(renderQueue, context, cache, backend, legacy);
+        }
+        double milliseconds =
+            std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+        std::vector<std::uint32_t> pixels = readFrame();
+        if (backend == RenderBackend::Immediate) {
+            reference = pixels;
+            immediateMilliseconds = milliseconds;
+        }
+        double differing = differingPixels(reference, pixels);
+        matched = matched && differing < 0.01;
+        std::printf("%-10s %8.3f ms/frame  speedup %.2fx  differing pixels %.3f%%\n",
+                    renderBackendName(backend), milliseconds, immediateMilliseconds / milliseconds,
+                    differing * 100.0);
+    }
+    if (!matched)
+        std::fprintf(stderr, "A backend differs from the immediate path in over 1%% of pixels\n");
+    return matched ? 0 : 1;
+}
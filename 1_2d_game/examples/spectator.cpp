@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "replication.hpp"
+
+// Example spectator of a game started with --serve.
+//
+// Connects over loopback UDP, rebuilds the game from the server's deltas and prints one line per
+// second: the replicated tick, health, bullet counts and the bandwidth received.
+//
+//   spectator [--port 45451] [--seconds N]
+
+int main(int argc, char **argv) {
+    int port = replication::DEFAULT_PORT;
+    int seconds = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--port PORT] [--seconds N]\n";
+            return 1;
+        }
+    }
+
+    ReplicationClient client;
+    if (port <= 0 || port > 65535 || !client.connect(static_cast<std::uint16_t>(port))) {
+        std::cerr << "Failed to connect: " << client.error() << '\n';
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto nextReport = start + std::chrono::seconds(1);
+    std::uint64_t bytesBefore = 0;
+    for (int elapsed = 0; seconds == 0 || elapsed < seconds;) {
+        client.poll();
+        if (std::chrono::steady_clock::now() < nextReport) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        const GameState &state = client.state();
+        std::printf("tick %d health %d boss %d bullets %zu/%zu %.1f kB/s\n", client.tick(),
+                    state.health, state.bossHealth, state.enemyBulletObjects.size(),
+                    state.playerBulletObjects.size(),
+                    static_cast<double>(client.bytesReceived() - bytesBefore) / 1000.0);
+        bytesBefore = client.bytesReceived();
+        nextReport += std::chrono::seconds(1);
+        elapsed++;
+    }
+    std::fprintf(stderr, "applied %llu snapshots (%llu full), received %llu bytes\n",
+                 static_cast<unsigned long long>(client.snapshotsApplied()),
+                 static_cast<unsigned long long>(client.fullSnapshots()),
+                 static_cast<unsigned long long>(client.bytesReceived()));
+    return 0;
+}
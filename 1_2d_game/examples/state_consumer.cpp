@@ -0,0 +1,72 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "shared_state.hpp"
+
+// Example consumer of the shared memory state export.
+//
+// Attaches to a game started with --export, then prints one line per new tick: the player, the
+// bullet counts and the enemy bullet closest to the player. Polls without ever blocking the game;
+// ticks that were overwritten before they could be read are counted as missed.
+//
+//   state_consumer [--name /cs451_game_state] [--ticks N]
+
+int main(int argc, char **argv) {
+    std::string name = shared_state::DEFAULT_NAME;
+    long long ticks = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--name" && i + 1 < argc) {
+            name = argv[++i];
+        } else if (arg == "--ticks" && i + 1 < argc) {
+            ticks = std::atoll(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--name NAME] [--ticks N]\n";
+            return 1;
+        }
+    }
+
+    StateReader reader;
+    if (!reader.attach(name)) {
+        std::cerr << "Failed to attach: " << reader.error() << '\n';
+        return 1;
+    }
+
+    SharedFrame frame;
+    long long lastTick = reader.latestTick();
+    long long received = 0;
+    long long missed = 0;
+    while (ticks == 0 || received < ticks) {
+        long long latest = reader.latestTick();
+        if (latest <= lastTick) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        // Catch up on every tick still in the ring, oldest first
+        long long first = std::max(lastTick + 1, latest - reader.slotCount() + 1);
+        missed += first - (lastTick + 1);
+        for (long long tick = first; tick <= latest; tick++) {
+            if (!reader.read(tick, frame)) {
+                missed++;
+                continue;
+            }
+            float nearest = INFINITY;
+            for (const SharedBullet &bullet : frame.enemyBullets) {
+                nearest = std::min(nearest, std::hypot(bullet.x - frame.playerX,
+                                                       bullet.y - frame.playerY));
+            }
+            std::printf("tick %d player (%.3f, %.3f) health %d boss %d bullets %zu/%zu "
+                        "nearest %.3f\n",
+                        frame.tick, frame.playerX, frame.playerY, frame.health, frame.bossHealth,
+                        frame.enemyBullets.size(), frame.playerBullets.size(), nearest);
+            received++;
+        }
+        lastTick = latest;
+    }
+    std::fprintf(stderr, "received %lld ticks, missed %lld\n", received, missed);
+    return 0;
+}
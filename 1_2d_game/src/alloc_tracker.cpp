@@ -0,0 +1,96 @@
+#include <cstdlib>
+#include <new>
+#include "alloc_tracker.hpp"
+
+// Replacement global allocation functions; see alloc_tracker.hpp. Every form forwards to one of
+// the two helpers below so plain, array, nothrow and aligned allocations are all counted.
+
+namespace {
+
+void *allocate(std::size_t size) {
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer != nullptr)
+        countAllocation(size);
+    return pointer;
+}
+
+void *allocateAligned(std::size_t size, std::align_val_t alignment) {
+    auto align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    void *pointer = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    // aligned_alloc requires the size to be a multiple of the alignment
+    std::size_t rounded = (size + align - 1) / align * align;
+    void *pointer = std::aligned_alloc(align, rounded == 0 ? align : rounded);
+#endif
+    if (pointer != nullptr)
+        countAllocation(size);
+    return pointer;
+}
+
+void release(void *pointer) {
+    if (pointer == nullptr)
+        return;
+    totalFrees.fetch_add(1, std::memory_order_relaxed);
+    std::free(pointer);
+}
+
+void releaseAligned(void *pointer) {
+    if (pointer == nullptr)
+        return;
+    totalFrees.fetch_add(1, std::memory_order_relaxed);
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+} // namespace
+
+void *operator new(std::size_t size) {
+    if (void *pointer = allocate(size))
+        return pointer;
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    if (void *pointer = allocateAligned(size, alignment))
+        return pointer;
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return allocateAligned(size, alignment);
+}
+void *operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t &) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void *pointer) noexcept { release(pointer); }
+void operator delete[](void *pointer) noexcept { release(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { release(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { release(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { release(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { release(pointer); }
+
+void operator delete(void *pointer, std::align_val_t) noexcept { releaseAligned(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { releaseAligned(pointer); }
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept {
+    releaseAligned(pointer);
+}
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept {
+    releaseAligned(pointer);
+}
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept {
+    releaseAligned(pointer);
+}
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept {
+    releaseAligned(pointer);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Heap allocation tracker.
+//
+// Linking alloc_tracker.cpp replaces the global operator new/delete with versions that count every
+// allocation, both process-wide and per thread. The build links it into the game executables only
+// when configured with -DALLOC_TRACKER=ON, which also defines ENABLE_ALLOC_TRACKER; otherwise the
+// counters below stay at zero.
+
+#ifdef ENABLE_ALLOC_TRACKER
+constexpr bool ALLOC_TRACKER_ENABLED = true;
+#else
+constexpr bool ALLOC_TRACKER_ENABLED = false;
+#endif
+
+/// @brief Number and total size of heap allocations
+struct AllocationCounters {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+
+    AllocationCounters operator-(const AllocationCounters &other) const {
+        return {allocations - other.allocations, bytes - other.bytes};
+    }
+};
+
+/// @brief Allocations made by the calling thread; only that thread writes it, so no atomics
+inline constinit thread_local AllocationCounters threadAllocations;
+
+/// @brief Allocations made by all threads
+inline constinit std::atomic<std::uint64_t> totalAllocations{0};
+inline constinit std::atomic<std::uint64_t> totalAllocatedBytes{0};
+inline constinit std::atomic<std::uint64_t> totalFrees{0};
+
+/// @brief Snapshot of the process-wide counters; subtract two snapshots to measure a span
+inline AllocationCounters allocationTotals() {
+    return {totalAllocations.load(std::memory_order_relaxed),
+            totalAllocatedBytes.load(std::memory_order_relaxed)};
+}
+
+/// @brief Called by the replaced operator new for every successful allocation
+inline void countAllocation(std::size_t bytes) {
+    threadAllocations.allocations++;
+    threadAllocations.bytes += bytes;
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    totalAllocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "game.hpp"
+#include "scenario.hpp"
+#include "thread_pool.hpp"
+
+// Many independent games stepped in lockstep, for evaluating bots and boss patterns headless.
+//
+// Inputs and outputs cross the API as flat arrays indexed by environment (one buttons byte, one
+// observation row, one reward and one done flag per game) so a policy can consume and produce
+// them in bulk. Each game keeps its own GameState, whose bullets are already contiguous, trivially
+// copyable arrays; games are stepped in chunks so threads do not share cache lines.
+
+/// @brief Layout of one row of BatchEnvironment::observations()
+namespace observation {
+constexpr int PLAYER_X = 0;
+constexpr int PLAYER_Y = 1;
+constexpr int BOSS_X = 2;
+constexpr int BOSS_Y = 3;
+constexpr int HEALTH = 4;
+constexpr int BOSS_HEALTH = 5;
+constexpr int ENEMY_BULLETS = 6;
+constexpr int PLAYER_BULLETS = 7;
+/// @brief Start of the player-relative (x, y) offsets of the nearest enemy bullets
+constexpr int NEAREST_BULLETS = 8;
+constexpr int NEAREST_BULLET_COUNT = 8;
+/// @brief Offset written for missing bullets, outside the [-1, 1] world
+constexpr float NO_BULLET = 4.0f;
+constexpr int SIZE = NEAREST_BULLETS + 2 * NEAREST_BULLET_COUNT;
+} // namespace observation
+
+/// @brief Settings shared by every game of a batch
+struct BatchConfig {
+    int health = 10;
+    int bossHealth = 100;
+    /// @brief Episodes end after this many ticks
+    int maxTicks = 3600;
+    /// @brief Seeded enemy bullets each episode starts with; the seed differs per game
+    int initialBullets = 0;
+};
+
+/// @brief N games stepped together across a thread pool, with flat input and output arrays
+class BatchEnvironment {
+  public:
+    /// @param threadCount Threads stepping the games, including the caller; 0 picks the core count
+    /// @param seed Base seed for the initial bullet fields
+    BatchEnvironment(std::size_t count, BatchConfig config = {}, unsigned threadCount = 0,
+                     std::uint32_t seed = 1)
+        : config_(config), seed_(seed), pool_(threadCount),
+          initial_(config.health, config.bossHealth), games_(count, initial_), ticks_(count, 0),
+          episodes_(count, 0), observations_(count * observation::SIZE), rewards_(count, 0.0f),
+          done_(count, 0) {
+        // Thousands of games would flood the output; reset() copies this into every game
+        initial_.logBossAttacks = false;
+        reset();
+    }
+
+    std::size_t size() const { return games_.size(); }
+    unsigned threadCount() const { return pool_.threadCount(); }
+
+    /// @brief Start a new episode in every game and refresh the observations
+    void reset() {
+        forEachChunk([this](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                resetGame(i);
+                rewards_[i] = 0.0f;
+                done_[i] = 0;
+                observe(i);
+            }
+        });
+    }
+
+    /// @brief Advance every game by one tick
+    /// @details Games whose episode ended in the previous step start a new one first, so the
+    /// final observation of an episode stays readable until the next step.
+    /// @param inputs size() bytes of TickInput::buttons, one per game
+    void step(const std::uint8_t *inputs) {
+        forEachChunk([this, inputs](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                stepGame(i, TickInput{inputs[i]});
+            }
+        });
+    }
+
+    /// @brief size() rows of observation::SIZE floats, row-major
+    const float *observations() const { return observations_.data(); }
+    /// @brief Per game: hits on the boss minus hits taken in the last step
+    const float *rewards() const { return rewards_.data(); }
+    /// @brief Per game: 1 if the last step ended the episode
+    const std::uint8_t *done() const { return done_.data(); }
+
+    const GameState &game(std::size_t index) const { return games_[index]; }
+    /// @brief Episodes started by a game so far, including the current one
+    int episodes(std::size_t index) const { return episodes_[index]; }
+
+  private:
+    /// @brief Games per task; large enough that chunk boundaries rarely share cache lines
+    static constexpr std::size_t CHUNK = 64;
+
+    template <typename F> void forEachChunk(F &&chunk) {
+        std::size_t count = games_.size();
+        pool_.parallelFor((count + CHUNK - 1) / CHUNK, [&](std::size_t index) {
+            chunk(index * CHUNK, std::min(count, (index + 1) * CHUNK));
+        });
+    }
+
+    void resetGame(std::size_t index) {
+        GameState &gameState = games_[index];
+        // Copy-assigning keeps the capacity the bullet vectors already have
+        gameState = initial_;
+        if (config_.initialBullets > 0) {
+            auto seed = static_cast<std::uint32_t>(seed_ + index * 7919 + episodes_[index]);
+            populateBulletField(gameState, config_.initialBullets, 0, seed);
+        }
+        ticks_[index] = 0;
+        episodes_[index]++;
+    }
+
+    void stepGame(std::size_t index, TickInput input) {
+        if (done_[index])
+            resetGame(index);
+        GameState &gameState = games_[index];
+        advanceTick(gameState, input, ticks_[index]);
+        ticks_[index]++;
+
+        rewards_[index] = static_cast<float>(gameState.bossHits - gameState.playerHits);
+        done_[index] = ticks_[index] >= config_.maxTicks;
+        observe(index);
+    }
+
+    void observe(std::size_t index) {
+        const GameState &gameState = games_[index];
+        float *row = &observations_[index * observation::SIZE];
+        glm::vec2 player = gameState.playerObject.currentPosition;
+        row[observation::PLAYER_X] = player.x;
+        row[observation::PLAYER_Y] = player.y;
+        row[observation::BOSS_X] = gameState.bossObject.currentPosition.x;
+        row[observation::BOSS_Y] = gameState.bossObject.currentPosition.y;
+        row[observation::HEALTH] = static_cast<float>(gameState.health);
+        row[observation::BOSS_HEALTH] = static_cast<float>(gameState.bossHealth);
+        row[observation::ENEMY_BULLETS] = static_cast<float>(gameState.enemyBulletObjects.size());
+        row[observation::PLAYER_BULLETS] =
+            static_cast<float>(gameState.playerBulletObjects.size());
+
+        // Insertion into a short sorted list: bullet counts per game are small and K is 8
+        constexpr int K = observation::NEAREST_BULLET_COUNT;
+        float nearestDistance[K];
+        glm::vec2 nearest[K];
+        int found = 0;
+        for (const EnemyBullet &bullet : gameState.enemyBulletObjects) {
+            glm::vec2 offset = bullet.currentPosition - player;
+            float distance = glm::dot(offset, offset);
+            if (found == K && distance >= nearestDistance[K - 1])
+                continue;
+            int slot = found < K ? found++ : K - 1;
+            for (; slot > 0 && nearestDistance[slot - 1] > distance; slot--) {
+                nearestDistance[slot] = nearestDistance[slot - 1];
+                nearest[slot] = nearest[slot - 1];
+            }
+            nearestDistance[slot] = distance;
+            nearest[slot] = offset;
+        }
+        float *offsets = row + observation::NEAREST_BULLETS;
+        for (int i = 0; i < K; i++) {
+            offsets[2 * i] = i < found ? nearest[i].x : observation::NO_BULLET;
+            offsets[2 * i + 1] = i < found ? nearest[i].y : observation::NO_BULLET;
+        }
+    }
+
+    BatchConfig config_;
+    std::uint32_t seed_;
+    ThreadPool pool_;
+    /// @brief State every episode starts from, before the seeded bullets
+    GameState initial_;
+    std::vector<GameState> games_;
+    std::vector<int> ticks_;
+    std::vector<int> episodes_;
+    std::vector<float> observations_;
+    std::vector<float> rewards_;
+    std::vector<std::uint8_t> done_;
+};
@@ -70,11 +70,14 @@ template <ShapeConcept A, ShapeConcept B> bool detectCollision(const A &a, const
     return a.intersects(b);
 }
 
-/// @brief Concept for objects that implement the Collidable Interface
+/// @brief Concept for objects that provide a collision shape
+/// @details Satisfied by implementations of the Collidable interface and by plain structs with a
+/// non-virtual getShape(), which stay trivially copyable
 /// @tparam T Type to check
-/// @return true if T is derived from Collidable
 template <typename T>
-concept CollidableObject = std::is_base_of_v<Collidable, T>;
+concept CollidableObject = requires(const T &object) {
+    { object.getShape() } -> std::same_as<CollisionShape>;
+};
 
 /// @breif Object-to-object collision detection (using their shapes)
 /// @tparam A Type of the first collidable objects
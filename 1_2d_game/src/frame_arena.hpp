@@ -0,0 +1,102 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+/// @brief Bump allocator for data that lives for one tick, usable as a std::pmr::memory_resource
+/// @details Allocation advances a pointer through one block; deallocation does nothing and reset()
+/// frees everything at once. When a tick needs more than the block holds, overflow blocks are
+/// taken from the upstream resource, and the next reset() replaces them all with one block large
+/// enough for the whole tick, so after warm-up the arena never touches the heap again.
+/// Not thread-safe; give each thread its own arena.
+///
+/// @code
+/// FrameArena arena;
+/// std::pmr::vector<int> scratch(&arena); // freed by the next arena.reset()
+/// @endcode
+class FrameArena : public std::pmr::memory_resource {
+  public:
+    explicit FrameArena(std::size_t capacity = 64 * 1024,
+                        std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {
+        block_ = {static_cast<std::byte *>(upstream_->allocate(capacity, BLOCK_ALIGNMENT)),
+                  capacity, BLOCK_ALIGNMENT};
+    }
+    ~FrameArena() override {
+        releaseOverflow();
+        upstream_->deallocate(block_.data, block_.size, BLOCK_ALIGNMENT);
+    }
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    /// @brief Invalidate every allocation made since the last reset
+    void reset() {
+        if (!overflow_.empty()) {
+            std::size_t total = block_.size;
+            for (const Block &block : overflow_) {
+                total += block.size;
+            }
+            releaseOverflow();
+            upstream_->deallocate(block_.data, block_.size, BLOCK_ALIGNMENT);
+            block_ = {static_cast<std::byte *>(upstream_->allocate(total, BLOCK_ALIGNMENT)), total,
+                      BLOCK_ALIGNMENT};
+        }
+        used_ = 0;
+    }
+
+    /// @brief Bytes handed out since the last reset, including alignment padding
+    std::size_t used() const {
+        std::size_t total = used_;
+        for (const Block &block : overflow_) {
+            total += block.size;
+        }
+        return total;
+    }
+    /// @brief Size of the main block, i.e. what a tick can use without reaching upstream
+    std::size_t capacity() const { return block_.size; }
+
+  private:
+    static constexpr std::size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+    struct Block {
+        std::byte *data;
+        std::size_t size;
+        std::size_t alignment;
+    };
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        // Align the address, not the offset: the block itself is only BLOCK_ALIGNMENT aligned
+        void *pointer = block_.data + used_;
+        std::size_t space = block_.size - used_;
+        if (overflow_.empty() && std::align(alignment, bytes, pointer, space)) {
+            used_ = block_.size - space + bytes;
+            return pointer;
+        }
+        // Overflow allocations get their own block; only happens until the next reset grows
+        std::size_t size = std::max(bytes, alignment);
+        alignment = std::max(alignment, BLOCK_ALIGNMENT);
+        overflow_.push_back(
+            {static_cast<std::byte *>(upstream_->allocate(size, alignment)), size, alignment});
+        return overflow_.back().data;
+    }
+    void do_deallocate(void * /*pointer*/, std::size_t /*bytes*/,
+                       std::size_t /*alignment*/) override {}
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    void releaseOverflow() {
+        for (const Block &block : overflow_) {
+            upstream_->deallocate(block.data, block.size, block.alignment);
+        }
+        overflow_.clear();
+    }
+
+    std::pmr::memory_resource *upstream_;
+    Block block_;
+    std::size_t used_ = 0;
+    /// @brief Blocks taken from upstream after the main block ran out this tick
+    std::vector<Block> overflow_;
+};
@@ -0,0 +1,249 @@
+#pragma once
+#include <GL/glew.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "image_io.hpp"
+
+/// @brief Background thread that encodes captured frames as numbered PPM files
+/// @details Pixel buffers are recycled through a free list, so steady-state capture does not
+/// allocate once the writer has caught up. If the disk cannot keep up, at most maxPending frames
+/// wait; further frames are dropped and counted rather than stalling the render thread or piling
+/// up in memory. Dropped frames leave gaps in the file numbers.
+class FrameWriter {
+  public:
+    /// @brief Default number of frames that may wait for the writer
+    static constexpr std::size_t MAX_PENDING = 8;
+
+    explicit FrameWriter(std::string directory, std::size_t maxPending = MAX_PENDING)
+        : directory_(std::move(directory)), maxPending_(std::max<std::size_t>(maxPending, 1)),
+          thread_([this] { writeLoop(); }) {}
+    ~FrameWriter() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+    FrameWriter(const FrameWriter &) = delete;
+    FrameWriter &operator=(const FrameWriter &) = delete;
+
+    /// @brief Get an empty buffer of the given size, reusing one the writer has finished with
+    std::vector<std::uint32_t> acquireBuffer(std::size_t pixelCount) {
+        std::vector<std::uint32_t> buffer;
+        {
+            std::lock_guard lock(mutex_);
+            if (!freeBuffers_.empty()) {
+                buffer = std::move(freeBuffers_.back());
+                freeBuffers_.pop_back();
+            }
+        }
+        buffer.resize(pixelCount);
+        return buffer;
+    }
+
+    /// @brief Queue a bottom-up RGBA frame (glReadPixels layout) for writing
+    /// @param wait Wait for room in a full queue instead of dropping the frame
+    /// @return false if the queue was full and the frame was dropped
+    bool push(int frameIndex, int width, int height, std::vector<std::uint32_t> &&pixels,
+              bool wait = false) {
+        {
+            std::unique_lock lock(mutex_);
+            if (wait)
+                space_.wait(lock, [this] { return pending_.size() < maxPending_; });
+            if (pending_.size() >= maxPending_) {
+                dropped_++;
+                freeBuffers_.push_back(std::move(pixels));
+                return false;
+            }
+            pending_.push_back({frameIndex, width, height, std::move(pixels)});
+        }
+        wake_.notify_one();
+        return true;
+    }
+
+    /// @brief Frames dropped because maxPending frames were already waiting
+    long long dropped() const {
+        std::lock_guard lock(mutex_);
+        return dropped_;
+    }
+
+  private:
+    struct Frame {
+        int index;
+        int width;
+        int height;
+        std::vector<std::uint32_t> pixels;
+    };
+
+    void writeLoop() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+            if (pending_.empty())
+                return;
+            Frame frame = std::move(pending_.front());
+            pending_.pop_front();
+            lock.unlock();
+            space_.notify_one();
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "/frame_%05d.ppm", frame.index);
+            if (!writePpm(directory_ + name, frame.width, frame.height, frame.pixels.data(), true))
+                std::cerr << "Failed to write " << directory_ + name << '\n';
+
+            lock.lock();
+            freeBuffers_.push_back(std::move(frame.pixels));
+        }
+    }
+
+    std::string directory_;
+    std::size_t maxPending_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    /// @brief Signaled when the writer takes a frame off the queue
+    std::condition_variable space_;
+    std::deque<Frame> pending_;
+    std::vector<std::vector<std::uint32_t>> freeBuffers_;
+    long long dropped_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+/// @brief Renders frames into an FBO and reads them back through a ring of pixel buffer objects
+/// @details glReadPixels into a PBO returns immediately; the PBO is only mapped ringSize frames
+/// later, when the GPU has long finished the copy, so capture never stalls the pipeline.
+/// Mapped frames are handed to a FrameWriter thread for encoding.
+class FrameCapture {
+  public:
+    /// @brief Create the FBO and PBO ring
+    /// @param ringSize Number of frames readback lags behind rendering
+    /// @return false if framebuffer objects or PBOs are unsupported
+    bool init(int width, int height, int ringSize, const std::string &directory) {
+        if (!GLEW_VERSION_3_0 && !GLEW_ARB_framebuffer_object)
+            return false;
+        if (!GLEW_VERSION_2_1 && !GLEW_ARB_pixel_buffer_object)
+            return false;
+
+        width_ = width;
+        height_ = height;
+
+        glGenFramebuffers(1, &framebuffer_);
+        glGenRenderbuffers(2, renderbuffers_);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers_[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers_[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                                  renderbuffers_[0]);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER,
+                                  renderbuffers_[1]);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Capture framebuffer incomplete: 0x" << std::hex << status << std::dec
+                      << '\n';
+            return false;
+        }
+
+        pixelBuffers_.resize(static_cast<std::size_t>(ringSize));
+        glGenBuffers(ringSize, pixelBuffers_.data());
+        for (GLuint buffer : pixelBuffers_) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes(), nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        writer_ = std::make_unique<FrameWriter>(directory);
+        return true;
+    }
+
+    bool enabled() const { return writer_ != nullptr; }
+    /// @brief The framebuffer frames are captured from, for drawing into it from elsewhere
+    GLuint framebuffer() const { return framebuffer_; }
+
+    /// @brief Redirect rendering of the current frame into the capture framebuffer
+    void beginFrame() {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+        glViewport(0, 0, width_, height_);
+    }
+
+    /// @brief Start the asynchronous readback of the frame and present it to the window
+    /// @param present false in offscreen mode, where the window is hidden
+    void endFrame(bool present) {
+        std::size_t slot = frameCount_ % pixelBuffers_.size();
+        if (frameCount_ >= static_cast<int>(pixelBuffers_.size())) {
+            collect(slot, frameCount_ - static_cast<int>(pixelBuffers_.size()));
+        }
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer_);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers_[slot]);
+        glReadPixels(0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        if (present) {
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            glBlitFramebuffer(0, 0, width_, height_, 0, 0, width_, height_, GL_COLOR_BUFFER_BIT,
+                              GL_NEAREST);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        frameCount_++;
+    }
+
+    /// @brief Read back the frames still in flight and wait for the writer to finish
+    /// @details The capture is ending, so these frames wait for room in the queue instead of
+    /// being dropped.
+    void finish() {
+        if (!enabled())
+            return;
+        int ringSize = static_cast<int>(pixelBuffers_.size());
+        int first = frameCount_ > ringSize ? frameCount_ - ringSize : 0;
+        for (int frame = first; frame < frameCount_; frame++) {
+            collect(static_cast<std::size_t>(frame % ringSize), frame, true);
+        }
+        if (writer_->dropped() > 0)
+            std::cerr << "Frame capture dropped " << writer_->dropped() << " of " << frameCount_
+                      << " frames; the disk could not keep up\n";
+        writer_.reset();
+    }
+
+  private:
+    GLsizeiptr frameBytes() const { return static_cast<GLsizeiptr>(width_) * height_ * 4; }
+
+    void collect(std::size_t slot, int frameIndex, bool wait = false) {
+        std::vector<std::uint32_t> pixels =
+            writer_->acquireBuffer(static_cast<std::size_t>(width_) * height_);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers_[slot]);
+        const void *mapped = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+        if (mapped != nullptr) {
+            std::memcpy(pixels.data(), mapped, static_cast<std::size_t>(frameBytes()));
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (mapped != nullptr)
+            writer_->push(frameIndex, width_, height_, std::move(pixels), wait);
+    }
+
+    int width_ = 0;
+    int height_ = 0;
+    GLuint framebuffer_ = 0;
+    GLuint renderbuffers_[2] = {0, 0};
+    std::vector<GLuint> pixelBuffers_;
+    int frameCount_ = 0;
+    std::unique_ptr<FrameWriter> writer_;
+};
@@ -0,0 +1,150 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <ostream>
+#include <thread>
+
+/// @brief Real time for FramePacer: the steady clock and the calling thread's sleeps
+struct SteadyPacerClock {
+    using duration = std::chrono::steady_clock::duration;
+    using time_point = std::chrono::steady_clock::time_point;
+
+    time_point now() const { return std::chrono::steady_clock::now(); }
+    void sleep(duration time) const { std::this_thread::sleep_for(time); }
+    void yield() const { std::this_thread::yield(); }
+};
+
+/// @brief Releases frames at a target rate without burning a core between them
+/// @details Without vsync, frames are due on a fixed cadence of the target period. The caller polls
+/// wait() in short slices: it sleeps while the frame is far off and spins through the last stretch,
+/// where a sleep could overshoot. Sleep overshoot is tracked, so coarse system timers lead to more
+/// spinning instead of late frames. A frame that misses its deadline is counted, and the cadence
+/// skips ahead instead of bursting frames to catch up.
+///
+/// With vsync the swap itself waits for the vertical blank. The pacer then releases each frame
+/// half a period after the previous present, so the swap blocks only briefly instead of spinning in
+/// the driver. This assumes the target is the display refresh rate. The median of the last
+/// VSYNC_CHECK_FRAMES present intervals is checked on every present; if it is well below the
+/// period, the swap interval is not honored and the pacer falls back to its own cadence. A median
+/// ignores the odd slow frame, and checking continuously keeps slow startup frames from hiding an
+/// ignored swap interval.
+/// @tparam Clock Source of time and sleeps; tests substitute a simulated one
+template <typename Clock = SteadyPacerClock> class BasicFramePacer {
+  public:
+    using Duration = typename Clock::duration;
+    using TimePoint = typename Clock::time_point;
+    /// @brief Shortest remaining wait that is spun instead of slept, before sleep overshoot
+    static constexpr Duration MIN_SPIN = std::chrono::microseconds(500);
+    /// @brief Present intervals whose median decides whether vsync holds frames to the period
+    static constexpr int VSYNC_CHECK_FRAMES = 30;
+
+    explicit BasicFramePacer(Clock clock = {}) : clock_(clock), next_(clock_.now()) {}
+
+    /// @param framesPerSecond Target rate; 0 releases every frame immediately
+    /// @param vsync Whether buffer swaps wait for the vertical blank
+    void configure(double framesPerSecond, bool vsync) {
+        period_ = framesPerSecond > 0.0 ? std::chrono::duration_cast<Duration>(
+                                              std::chrono::duration<double>(1.0 / framesPerSecond))
+                                        : Duration::zero();
+        vsync_ = vsync;
+        vsyncFellBack_ = false;
+        intervalCount_ = 0;
+        next_ = clock_.now();
+    }
+
+    double targetFramesPerSecond() const {
+        return period_ == Duration::zero() ? 0.0
+                                           : 1.0 / std::chrono::duration<double>(period_).count();
+    }
+    bool vsync() const { return vsync_; }
+    /// @brief Whether vsync was requested but presents showed it had no effect
+    bool vsyncFellBack() const { return vsyncFellBack_; }
+    long long presentedFrames() const { return presentedFrames_; }
+    /// @brief Frames presented over half a period late (with vsync: over 1.5 periods apart)
+    long long missedFrames() const { return missedFrames_; }
+
+    /// @brief Wait toward the next frame for at most maxSleep
+    /// @return true once the next frame is due; false if the caller should poll again
+    bool wait(Duration maxSleep) {
+        if (period_ == Duration::zero())
+            return true;
+        TimePoint release = vsync_ ? next_ - period_ / 2 : next_;
+        TimePoint now = clock_.now();
+        if (now >= release)
+            return true;
+        Duration remaining = release - now;
+        Duration spin = MIN_SPIN + oversleep_;
+        if (remaining > spin) {
+            Duration slice = std::min(remaining - spin, maxSleep);
+            clock_.sleep(slice);
+            Duration overshoot = clock_.now() - now - slice;
+            // A moving average: coarse timers raise it for good, a single preemption barely does
+            oversleep_ = (oversleep_ * 7 + std::max(overshoot, Duration::zero())) / 8;
+            return false;
+        }
+        while (clock_.now() < release) {
+            clock_.yield();
+        }
+        return true;
+    }
+
+    /// @brief A frame was presented; schedule the next one
+    void presented(TimePoint time) {
+        presentedFrames_++;
+        if (period_ == Duration::zero())
+            return;
+        if (vsync_) {
+            if (presentedFrames_ > 1) {
+                if (time - previousPresent_ > period_ * 3 / 2)
+                    missedFrames_++;
+                checkVsync(time - previousPresent_);
+            }
+            // The vertical blank sets the cadence; the next one is a period after this present
+            next_ = time + period_;
+        } else {
+            if (time - next_ > period_ / 2)
+                missedFrames_++;
+            // Stay on the cadence; skip the deadlines that already passed
+            next_ += period_;
+            if (next_ <= time)
+                next_ += ((time - next_) / period_ + 1) * period_;
+        }
+        previousPresent_ = time;
+    }
+
+    void printSummary(std::ostream &out) const {
+        out << "[frame pacing] target " << targetFramesPerSecond() << " fps"
+            << (vsync_ ? " with vsync" : (vsyncFellBack_ ? ", vsync not honored" : ""))
+            << ", missed " << missedFrames_ << " of " << presentedFrames_ << " frames\n";
+    }
+
+  private:
+    /// @brief Fall back if the median of the recent present intervals is well below the period
+    void checkVsync(Duration interval) {
+        intervals_[static_cast<std::size_t>(intervalCount_++ % VSYNC_CHECK_FRAMES)] = interval;
+        if (intervalCount_ < VSYNC_CHECK_FRAMES)
+            return;
+        std::array<Duration, VSYNC_CHECK_FRAMES> sorted = intervals_;
+        auto middle = sorted.begin() + VSYNC_CHECK_FRAMES / 2;
+        std::nth_element(sorted.begin(), middle, sorted.end());
+        if (*middle < period_ * 3 / 4) {
+            vsync_ = false;
+            vsyncFellBack_ = true;
+        }
+    }
+
+    Clock clock_;
+    Duration period_ = Duration::zero();
+    bool vsync_ = false;
+    bool vsyncFellBack_ = false;
+    TimePoint next_;
+    TimePoint previousPresent_;
+    std::array<Duration, VSYNC_CHECK_FRAMES> intervals_{};
+    long long intervalCount_ = 0;
+    Duration oversleep_ = Duration::zero();
+    long long presentedFrames_ = 0;
+    long long missedFrames_ = 0;
+};
+
+using FramePacer = BasicFramePacer<>;
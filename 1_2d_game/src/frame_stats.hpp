@@ -0,0 +1,174 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include "frame_timing.hpp"
+
+/// @brief Log-linear (HDR-style) histogram of durations, recorded in nanoseconds
+/// @details Values below 64 ns get exact buckets; above that, each power of two is split into 32
+/// buckets, so every recorded value keeps about 3% relative precision up to half an hour. Storage
+/// is a fixed array, so recording never allocates.
+class DurationHistogram {
+  public:
+    static constexpr int SUB_BUCKET_BITS = 6;
+    static constexpr std::uint64_t SUB_BUCKETS = 1ull << SUB_BUCKET_BITS;
+    static constexpr std::uint64_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+    static constexpr int MAGNITUDES = 36;
+    static constexpr std::size_t BUCKET_COUNT = SUB_BUCKETS + MAGNITUDES * HALF_SUB_BUCKETS;
+
+    void record(double milliseconds) {
+        auto nanoseconds = static_cast<std::uint64_t>(std::max(0.0, milliseconds) * 1e6);
+        counts_[bucketOf(nanoseconds)]++;
+        count_++;
+        max_ = std::max(max_, nanoseconds);
+        sum_ += nanoseconds;
+    }
+    void reset() {
+        counts_.fill(0);
+        count_ = 0;
+        max_ = 0;
+        sum_ = 0;
+    }
+
+    std::uint64_t count() const { return count_; }
+    double maxMilliseconds() const { return static_cast<double>(max_) / 1e6; }
+    double meanMilliseconds() const {
+        return count_ == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(count_) / 1e6;
+    }
+
+    /// @brief Value at or below which the given fraction of recorded values fall
+    /// @param fraction Between 0 and 1, e.g. 0.99 for the 99th percentile
+    /// @return Upper bound of the bucket holding that value, capped at the maximum, in ms
+    double percentileMilliseconds(double fraction) const {
+        if (count_ == 0)
+            return 0.0;
+        auto rank = static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(count_)));
+        rank = std::clamp<std::uint64_t>(rank, 1, count_);
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            seen += counts_[bucket];
+            if (seen >= rank)
+                return static_cast<double>(std::min(upperBoundOf(bucket), max_)) / 1e6;
+        }
+        return maxMilliseconds();
+    }
+
+  private:
+    static std::size_t bucketOf(std::uint64_t value) {
+        int magnitude = std::bit_width(value) - SUB_BUCKET_BITS;
+        if (magnitude <= 0)
+            return static_cast<std::size_t>(value);
+        magnitude = std::min(magnitude, MAGNITUDES);
+        std::uint64_t subBucket = std::min(value >> magnitude, SUB_BUCKETS - 1);
+        return SUB_BUCKETS + (magnitude - 1) * HALF_SUB_BUCKETS + (subBucket - HALF_SUB_BUCKETS);
+    }
+    static std::uint64_t upperBoundOf(std::size_t bucket) {
+        if (bucket < SUB_BUCKETS)
+            return bucket;
+        std::size_t magnitude = (bucket - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+        std::uint64_t subBucket = (bucket - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+        return ((subBucket + 1) << magnitude) - 1;
+    }
+
+    std::array<std::uint64_t, BUCKET_COUNT> counts_{};
+    std::uint64_t count_ = 0;
+    std::uint64_t max_ = 0;
+    std::uint64_t sum_ = 0;
+};
+
+/// @brief Frame and tick duration percentiles plus automatic hitch capture
+/// @details Per-phase timings of recent frames come from the FrameTimings ring; whenever a frame
+/// takes longer than the hitch threshold, that ring is written to hitch_<frame>.csv so the frames
+/// leading up to the spike can be inspected.
+class FrameStats {
+  public:
+    /// @brief Frames longer than this are hitches; 0 disables hitch dumps
+    double hitchThresholdMilliseconds = 50.0;
+    /// @brief Minimum number of frames between two hitch dumps
+    int hitchCooldownFrames = FrameTimings::HISTORY_SIZE / 2;
+    std::string hitchDirectory = ".";
+
+    DurationHistogram frames;
+    DurationHistogram ticks;
+    /// @brief From an input event to the present of the first frame showing it (see InputLatency)
+    DurationHistogram inputLatency;
+    /// @brief From an input event until the input was sampled
+    DurationHistogram inputWait;
+
+    void recordTick(double milliseconds) { ticks.record(milliseconds); }
+
+    /// @brief Record a committed frame and dump the timing ring if it was a hitch
+    /// @param timings Timing ring whose most recent frame is the one being recorded
+    /// @return true if a hitch dump was written
+    bool recordFrame(double milliseconds, const FrameTimings &timings) {
+        frames.record(milliseconds);
+        long long frame = timings.frameCount();
+        if (hitchThresholdMilliseconds <= 0.0 || milliseconds <= hitchThresholdMilliseconds)
+            return false;
+        hitchCount_++;
+        if (lastDumpFrame_ >= 0 && frame - lastDumpFrame_ < hitchCooldownFrames)
+            return false;
+        lastDumpFrame_ = frame;
+
+        char name[48];
+        std::snprintf(name, sizeof(name), "/hitch_%06lld.csv", frame);
+        std::ofstream file(hitchDirectory + name);
+        timings.writeCsv(file);
+        return static_cast<bool>(file);
+    }
+
+    long long hitchCount() const { return hitchCount_; }
+
+    void printSummary(std::ostream &out) const {
+        printHistogram(out, "frame", frames);
+        printHistogram(out, "tick", ticks);
+        if (inputLatency.count() > 0) {
+            printHistogram(out, "input latency", inputLatency);
+            printHistogram(out, "input wait", inputWait);
+        }
+        out << "[frame stats] hitches over " << hitchThresholdMilliseconds
+            << " ms: " << hitchCount_ << '\n';
+    }
+
+    void writeJson(std::ostream &out) const {
+        out << "{\n";
+        writeHistogramJson(out, "frame", frames);
+        out << ",\n";
+        writeHistogramJson(out, "tick", ticks);
+        out << ",\n";
+        writeHistogramJson(out, "input_latency", inputLatency);
+        out << ",\n";
+        writeHistogramJson(out, "input_wait", inputWait);
+        out << ",\n  \"hitch_threshold_ms\": " << hitchThresholdMilliseconds
+            << ",\n  \"hitches\": " << hitchCount_ << "\n}\n";
+    }
+
+  private:
+    static void printHistogram(std::ostream &out, const char *name,
+                               const DurationHistogram &histogram) {
+        out << "[frame stats] " << name << " n=" << histogram.count()
+            << " mean=" << histogram.meanMilliseconds()
+            << " p50=" << histogram.percentileMilliseconds(0.50)
+            << " p95=" << histogram.percentileMilliseconds(0.95)
+            << " p99=" << histogram.percentileMilliseconds(0.99)
+            << " max=" << histogram.maxMilliseconds() << " ms\n";
+    }
+    static void writeHistogramJson(std::ostream &out, const char *name,
+                                   const DurationHistogram &histogram) {
+        out << "  \"" << name << "\": {\"count\": " << histogram.count()
+            << ", \"mean_ms\": " << histogram.meanMilliseconds()
+            << ", \"p50_ms\": " << histogram.percentileMilliseconds(0.50)
+            << ", \"p95_ms\": " << histogram.percentileMilliseconds(0.95)
+            << ", \"p99_ms\": " << histogram.percentileMilliseconds(0.99)
+            << ", \"max_ms\": " << histogram.maxMilliseconds() << "}";
+    }
+
+    long long hitchCount_ = 0;
+    long long lastDumpFrame_ = -1;
+};
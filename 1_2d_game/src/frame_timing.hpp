@@ -0,0 +1,120 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <ostream>
+
+/// @brief Measured phases of a frame, in execution order
+enum class Phase : int { Input, Update, Collision, Export, RenderPrep, Present, Gpu, Count };
+
+constexpr int PHASE_COUNT = static_cast<int>(Phase::Count);
+
+inline const char *phaseName(Phase phase) {
+    static constexpr const char *NAMES[PHASE_COUNT] = {
+        "input", "update", "collision", "export", "render_prep", "present", "gpu"};
+    return NAMES[static_cast<int>(phase)];
+}
+
+/// @brief Per-phase durations of the most recent frames, kept in a fixed ring
+/// @details Phases can be measured several times per frame (e.g. two simulation ticks before one
+/// display); their durations are summed until commitFrame() closes the frame.
+class FrameTimings {
+  public:
+    static constexpr int HISTORY_SIZE = 256;
+    using Frame = std::array<float, PHASE_COUNT>;
+
+    /// @brief Add a duration to a phase of the frame being recorded
+    void add(Phase phase, double milliseconds) {
+        current_[static_cast<int>(phase)] += static_cast<float>(milliseconds);
+    }
+
+    /// @brief Close the frame being recorded and start the next one
+    void commitFrame() {
+        history_[next_] = current_;
+        current_.fill(0.0f);
+        next_ = (next_ + 1) % HISTORY_SIZE;
+        frameCount_++;
+    }
+
+    /// @brief Number of committed frames since start
+    long long frameCount() const { return frameCount_; }
+    /// @brief Number of frames held in the history
+    int size() const { return static_cast<int>(std::min<long long>(frameCount_, HISTORY_SIZE)); }
+    /// @brief A frame of the history; age 0 is the most recent committed frame
+    const Frame &frame(int age) const {
+        return history_[(next_ - 1 - age + 2 * HISTORY_SIZE) % HISTORY_SIZE];
+    }
+
+    double average(Phase phase) const {
+        if (size() == 0)
+            return 0.0;
+        double sum = 0.0;
+        for (int age = 0; age < size(); age++) {
+            sum += frame(age)[static_cast<int>(phase)];
+        }
+        return sum / size();
+    }
+    double max(Phase phase) const {
+        float result = 0.0f;
+        for (int age = 0; age < size(); age++) {
+            result = std::max(result, frame(age)[static_cast<int>(phase)]);
+        }
+        return result;
+    }
+
+    /// @brief Write the history oldest first, one row per frame, durations in milliseconds
+    void writeCsv(std::ostream &out) const {
+        out << "frame";
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            out << ',' << phaseName(static_cast<Phase>(phase));
+        }
+        out << '\n';
+        for (int age = size() - 1; age >= 0; age--) {
+            out << frameCount_ - 1 - age;
+            for (float milliseconds : frame(age)) {
+                out << ',' << milliseconds;
+            }
+            out << '\n';
+        }
+    }
+
+    /// @brief Write per-phase summaries and the history as JSON, durations in milliseconds
+    void writeJson(std::ostream &out) const {
+        out << "{\n  \"frames\": " << size() << ",\n  \"phases\": {\n";
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            out << "    \"" << phaseName(static_cast<Phase>(phase))
+                << "\": {\"average_ms\": " << average(static_cast<Phase>(phase))
+                << ", \"max_ms\": " << max(static_cast<Phase>(phase)) << ", \"history_ms\": [";
+            for (int age = size() - 1; age >= 0; age--) {
+                out << frame(age)[phase] << (age > 0 ? ", " : "");
+            }
+            out << "]}" << (phase + 1 < PHASE_COUNT ? ",\n" : "\n");
+        }
+        out << "  }\n}\n";
+    }
+
+  private:
+    std::array<Frame, HISTORY_SIZE> history_{};
+    Frame current_{};
+    int next_ = 0;
+    long long frameCount_ = 0;
+};
+
+/// @brief Adds the wall time of its scope to a phase of the current frame
+class ScopedCpuTimer {
+  public:
+    ScopedCpuTimer(FrameTimings &timings, Phase phase)
+        : timings_(timings), phase_(phase), start_(Clock::now()) {}
+    ~ScopedCpuTimer() {
+        timings_.add(phase_,
+                     std::chrono::duration<double, std::milli>(Clock::now() - start_).count());
+    }
+    ScopedCpuTimer(const ScopedCpuTimer &) = delete;
+    ScopedCpuTimer &operator=(const ScopedCpuTimer &) = delete;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    FrameTimings &timings_;
+    Phase phase_;
+    Clock::time_point start_;
+};
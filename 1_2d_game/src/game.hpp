@@ -0,0 +1,348 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "collision.hpp"
+#include "profiler.hpp"
+#include "render.hpp"
+#include "stats.hpp"
+
+/// @brief Simulation tick length in milliseconds
+constexpr int TICK_MS = 16;
+
+/// @brief Player movement speed in world units per millisecond
+constexpr float PLAYER_SPEED = 0.0005f;
+
+/// @brief Simulation time of a tick in milliseconds; the simulation only advances in whole ticks
+constexpr int tickTime(int tick) { return tick * TICK_MS; }
+
+/// @brief Buttons that can be held during a tick, as bits of TickInput::buttons
+enum class InputButton : std::uint8_t {
+    Up = 1 << 0,
+    Left = 1 << 1,
+    Down = 1 << 2,
+    Right = 1 << 3,
+    Attack = 1 << 4,
+};
+
+/// @brief Player input of one simulation tick
+struct TickInput {
+    std::uint8_t buttons = 0;
+
+    bool held(InputButton button) const {
+        return (buttons & static_cast<std::uint8_t>(button)) != 0;
+    }
+    void press(InputButton button) { buttons |= static_cast<std::uint8_t>(button); }
+};
+
+/// @brief Interface for objects that can be drawn
+struct Drawable {
+    /// @brief Submit the object's draw commands in world coordinates to the context's queue
+    /// @param context The render context of the current frame
+    virtual void draw(const RenderContext &context) = 0;
+    virtual ~Drawable() = default;
+};
+
+struct GameState;
+
+/// @brief Interface for objects that can be updated
+struct Updatable {
+    /// @brief Update the object's state. Return true if the object should be removed.
+    /// @param deltaTime Time elapsed since the last update in milliseconds
+    /// @return true if the object should be removed
+    virtual bool update(int currentTime, GameState &gameState) = 0;
+    virtual ~Updatable() = default;
+};
+
+// The bullets implement the Updatable, Drawable and Collidable members without deriving from the
+// interfaces: without vtable pointers they are trivially copyable, so the bullet vectors copy as
+// plain memory (see snapshot.hpp) and take less cache per bullet.
+
+struct EnemyBullet {
+    glm::fvec2 initialDirection;
+    glm::fvec2 normalDirection;
+    glm::fvec2 initialPosition;
+    glm::fvec2 currentPosition;
+    int initialTime;
+    float speed;
+
+    static constexpr float RADIUS = 0.03f;
+
+    EnemyBullet(glm::fvec2 initialDirection, glm::fvec2 initialPosition, float speed,
+                int initialTime)
+        : initialDirection(glm::normalize(initialDirection) * speed),
+          normalDirection(glm::normalize(glm::fvec2(-initialDirection.y, initialDirection.x))),
+          initialPosition(initialPosition), currentPosition(initialPosition),
+          initialTime(initialTime), speed(speed) {}
+
+    float pos(int t) {
+        float deltaX = static_cast<float>(t) * speed; // f/ms
+        return std::sqrt(deltaX);
+    }
+    bool update(int currentTime, GameState &gameState) {
+        int dt = currentTime - initialTime;
+        currentPosition =
+            initialPosition + float(dt) * initialDirection + pos(dt) * normalDirection;
+        return std::abs(currentPosition.x) > 1.0f || std::abs(currentPosition.y) > 1.0f;
+    }
+    void draw(const RenderContext &context) {
+        context.queue.drawSdfCircle(currentPosition, RADIUS, 10, glm::fvec3(1.0f, 1.0f, 1.0f),
+                                    Layer::EnemyBullets);
+    }
+    CollisionShape getShape() const { return CollisionCircle(currentPosition, RADIUS); }
+};
+
+struct PlayerBullet {
+    glm::fvec2 initialPosition;
+    glm::fvec2 currentPosition;
+    int initialTime;
+    float speed;
+
+    static constexpr float SIZE = 0.03f;
+
+    PlayerBullet(glm::fvec2 initialPosition, float speed, int initialTime)
+        : initialPosition(initialPosition), currentPosition(initialPosition),
+          initialTime(initialTime), speed(speed) {}
+
+    bool update(int currentTime, GameState &gameState) {
+        currentPosition =
+            initialPosition + glm::fvec2(0, speed * static_cast<float>(currentTime - initialTime));
+        return std::abs(currentPosition.x) > 1.0f || std::abs(currentPosition.y) > 1.0f;
+        ;
+    }
+    void draw(const RenderContext &context) {
+        context.queue.drawRect(currentPosition, SIZE, glm::fvec3(1.0f, 0.0f, 1.0f),
+                               Layer::PlayerBullets);
+    }
+    CollisionShape getShape() const {
+        return CollisionRectangle(currentPosition - SIZE / 2.0f, currentPosition + SIZE / 2.0f);
+    }
+};
+
+struct Player : Updatable, Drawable, Collidable {
+    glm::fvec2 currentPosition;
+    bool isBullet = false;
+    int coolTime = 0;
+
+    static constexpr float SIZE = 0.1f;
+
+    Player(glm::fvec2 initialPosition) : currentPosition(initialPosition) {}
+    ~Player() override {}
+
+    void tryAttack() { isBullet = true; }
+    bool update(int currentTime, GameState &gameState) override;
+    void draw(const RenderContext &context) override {
+        context.queue.drawTriangle(currentPosition, SIZE, glm::fvec3(1.0f, 1.0f, 0.0f),
+                                   Layer::Player);
+    }
+    void move(glm::fvec2 deltaPosition) {
+        currentPosition += deltaPosition;
+
+        // Clamp
+        if (currentPosition.x < -1.0f)
+            currentPosition.x = -1.0f;
+        if (currentPosition.x > 1.0f)
+            currentPosition.x = 1.0f;
+        if (currentPosition.y < -1.0f)
+            currentPosition.y = -1.0f;
+        if (currentPosition.y > 1.0f)
+            currentPosition.y = 1.0f;
+    }
+    CollisionShape getShape() const override {
+        return CollisionRectangle(currentPosition - SIZE / 2.0f, currentPosition + SIZE / 2.0f);
+    }
+};
+
+struct Boss : Updatable, Drawable, Collidable {
+    glm::fvec2 currentPosition;
+    int cooltime = 0;
+
+    static constexpr float RADIUS = 0.05f;
+
+    Boss(glm::fvec2 initialPosition) : currentPosition(initialPosition) {}
+    ~Boss() override {}
+
+    bool update(int currentTime, GameState &gameState) override;
+    void draw(const RenderContext &context) override {
+        context.queue.drawSdfCircle(currentPosition, RADIUS, 20, glm::fvec3(0.1f, 0.0f, 1.0f),
+                                    Layer::Boss);
+    }
+    CollisionShape getShape() const override { return CollisionCircle(currentPosition, RADIUS); }
+};
+
+struct Hearts : Drawable {
+    glm::fvec2 drawPosition;
+
+    Hearts(glm::fvec2 drawPosition) : drawPosition(drawPosition) {}
+    ~Hearts() override {}
+
+    void draw(const RenderContext & /*context*/) override {}
+};
+
+struct BossHealthBar : Drawable {
+    glm::fvec2 drawPosition;
+
+    BossHealthBar(glm::fvec2 drawPosition) : drawPosition(drawPosition) {}
+    ~BossHealthBar() override {}
+
+    void draw(const RenderContext & /*context*/) override {}
+};
+
+struct GameState {
+    GameState(int h, int bh)
+        : health(h), bossHealth(bh), cameraOffset(0.0f, 0.0f), playerObject(glm::fvec2(0.0f, 0.0f)),
+          bossObject(glm::fvec2(0.0f, 0.0f)), bossHealthBarObject(glm::fvec2(0.0f, 0.0f)),
+          heartsObject(glm::fvec2(0.0f, 0.0f)) {}
+
+    int health;
+    int bossHealth;
+    glm::fvec2 cameraOffset;
+    /// @brief Enemy bullets touching the player in the last tick; counted only, costs no health
+    int playerHits = 0;
+    /// @brief Player bullets touching the boss in the last tick; counted only, costs no health
+    int bossHits = 0;
+    /// @brief Print a line for every boss attack; batch runs of many games turn this off
+    bool logBossAttacks = true;
+
+    Player playerObject;
+    Boss bossObject;
+    BossHealthBar bossHealthBarObject;
+    Hearts heartsObject;
+
+    std::vector<PlayerBullet> playerBulletObjects;
+    std::vector<EnemyBullet> enemyBulletObjects;
+};
+
+inline bool Player::update(int currentTime, GameState &gameState) {
+    if (currentTime >= this->coolTime && this->isBullet) {
+        gameState.playerBulletObjects.emplace_back(this->currentPosition, 0.001f, currentTime);
+        this->isBullet = false;
+        this->coolTime = currentTime + 200;
+    }
+    return false;
+}
+
+inline bool Boss::update(int currentTime, GameState &gameState) {
+    PROFILE_ZONE("Boss::update");
+    if (this->cooltime > currentTime)
+        return false;
+    this->cooltime = currentTime + 200;
+
+    EnemyBullet testBullet1(glm::fvec2(1.0f, 0.0f), glm::fvec2(0.0f, 0.0f), 0.001f, currentTime);
+    EnemyBullet testBullet2(glm::fvec2(1.0f, 0.0f), glm::fvec2(0.0f, 0.0f), 0.002f, currentTime);
+    gameState.enemyBulletObjects.push_back(testBullet1);
+    gameState.enemyBulletObjects.push_back(testBullet2);
+
+    if (gameState.logBossAttacks) {
+        std::cout << currentTime << ", " << gameState.bossHealth << ", "
+                  << gameState.enemyBulletObjects.size() << '\n';
+    }
+    return false;
+}
+
+/// @brief Move the player by the held direction buttons
+/// @param step Distance per button
+inline void movePlayer(Player &player, TickInput input, float step) {
+    if (input.held(InputButton::Up))
+        player.move(glm::vec2(0.0f, step));
+    if (input.held(InputButton::Left))
+        player.move(glm::vec2(-step, 0.0f));
+    if (input.held(InputButton::Down))
+        player.move(glm::vec2(0.0f, -step));
+    if (input.held(InputButton::Right))
+        player.move(glm::vec2(step, 0.0f));
+}
+
+/// @brief Apply the input of one tick to the player
+inline void applyInput(GameState &gameState, TickInput input) {
+    movePlayer(gameState.playerObject, input, PLAYER_SPEED * static_cast<float>(TICK_MS));
+    if (input.held(InputButton::Attack))
+        gameState.playerObject.tryAttack();
+}
+
+/// @brief Where the player would be after holding the input for part of the coming tick
+/// @details Late latching draws the player here. The simulation itself is untouched and moves the
+/// player by the same amount once the tick runs with that input.
+/// @param elapsedMs Time since the last simulated tick, at most TICK_MS
+inline glm::vec2 latchedPlayerPosition(const GameState &gameState, TickInput input,
+                                       int elapsedMs) {
+    Player player = gameState.playerObject;
+    movePlayer(player, input, PLAYER_SPEED * static_cast<float>(elapsedMs));
+    return player.currentPosition;
+}
+
+/// @brief Advance every object to the given simulation time, removing expired bullets
+/// @param currentTime Simulation time in milliseconds
+inline void updateGame(GameState &gameState, int currentTime) {
+    PROFILE_ZONE("updateGame");
+    {
+        PROFILE_ZONE("update enemy bullets");
+        std::erase_if(gameState.enemyBulletObjects,
+                      [&](auto &it) { return it.update(currentTime, gameState); });
+    }
+    {
+        PROFILE_ZONE("update player bullets");
+        std::erase_if(gameState.playerBulletObjects,
+                      [&](auto &it) { return it.update(currentTime, gameState); });
+    }
+
+    gameState.playerObject.update(currentTime, gameState);
+    gameState.bossObject.update(currentTime, gameState);
+}
+
+/// @brief Count the bullets touching the player and the boss into playerHits and bossHits
+/// @details This is the collision phase of a tick. Hits do not change the game: bullets pass
+/// through, and health is left alone.
+inline void countHits(GameState &gameState) {
+    PROFILE_ZONE("countHits");
+    gameState.playerHits = static_cast<int>(
+        std::count_if(gameState.enemyBulletObjects.begin(), gameState.enemyBulletObjects.end(),
+                      [&](const EnemyBullet &bullet) {
+                          return detectCollision(bullet, gameState.playerObject);
+                      }));
+    gameState.bossHits = static_cast<int>(
+        std::count_if(gameState.playerBulletObjects.begin(), gameState.playerBulletObjects.end(),
+                      [&](const PlayerBullet &bullet) {
+                          return detectCollision(bullet, gameState.bossObject);
+                      }));
+}
+
+/// @brief Simulate one whole tick: apply its input, update and count hits
+/// @param tick Index of the tick, counted from zero
+inline void advanceTick(GameState &gameState, TickInput input, int tick) {
+    applyInput(gameState, input);
+    updateGame(gameState, tickTime(tick));
+    countHits(gameState);
+}
+
+/// @brief Draw an object only if its bounds overlap the view, counting the result in stats
+/// @tparam T Type of the object, which is bounded by its collision shape
+template <typename T> void drawVisible(T &object, const RenderContext &context, Stats &stats) {
+    if (!context.isVisible(object)) {
+        stats.culled++;
+        return;
+    }
+    object.draw(context);
+    stats.drawn++;
+}
+
+/// @brief Upper bound on the number of commands submitGame() adds to a queue
+inline std::size_t submitCapacity(const GameState &gameState) {
+    return gameState.enemyBulletObjects.size() + gameState.playerBulletObjects.size() + 2;
+}
+
+/// @brief Submit every visible object of the game to the render queue of the context
+inline void submitGame(GameState &gameState, const RenderContext &context, Stats &stats) {
+    PROFILE_ZONE("submitGame");
+    for (auto &object : gameState.enemyBulletObjects) {
+        drawVisible(object, context, stats);
+    }
+    for (auto &object : gameState.playerBulletObjects) {
+        drawVisible(object, context, stats);
+    }
+    drawVisible(gameState.playerObject, context, stats);
+    drawVisible(gameState.bossObject, context, stats);
+}
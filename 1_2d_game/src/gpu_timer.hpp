@@ -0,0 +1,62 @@
+#pragma once
+#include <GL/glew.h>
+
+/// @brief Measures GPU time of a span of GL commands with GL_TIME_ELAPSED queries
+/// @details Queries are kept in a small ring and only read once GL reports them available, a few
+/// frames later, so reading results never stalls the pipeline. If every query of the ring is still
+/// in flight, the current frame is not measured.
+class GpuTimer {
+  public:
+    static constexpr int RING_SIZE = 4;
+
+    /// @return false if timer queries are unsupported; begin/end/poll then do nothing
+    bool init() {
+        if (!GLEW_VERSION_3_3 && !GLEW_ARB_timer_query)
+            return false;
+        glGenQueries(RING_SIZE, queries_);
+        supported_ = true;
+        return true;
+    }
+
+    bool supported() const { return supported_; }
+
+    void begin() {
+        measuring_ = supported_ && issued_ - collected_ < RING_SIZE;
+        if (measuring_)
+            glBeginQuery(GL_TIME_ELAPSED, queries_[issued_ % RING_SIZE]);
+    }
+    void end() {
+        if (!measuring_)
+            return;
+        glEndQuery(GL_TIME_ELAPSED);
+        issued_++;
+        measuring_ = false;
+    }
+
+    /// @brief Collect finished queries without waiting
+    /// @param milliseconds Set to the most recent finished measurement, if any
+    /// @return true if at least one new measurement was collected
+    bool poll(double &milliseconds) {
+        bool collected = false;
+        while (collected_ < issued_) {
+            GLuint query = queries_[collected_ % RING_SIZE];
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available != GL_TRUE)
+                break;
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+            milliseconds = static_cast<double>(nanoseconds) / 1.0e6;
+            collected_++;
+            collected = true;
+        }
+        return collected;
+    }
+
+  private:
+    GLuint queries_[RING_SIZE] = {};
+    bool supported_ = false;
+    bool measuring_ = false;
+    int issued_ = 0;
+    int collected_ = 0;
+};
@@ -0,0 +1,306 @@
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "alloc_tracker.hpp"
+#include "frame_arena.hpp"
+#include "frame_stats.hpp"
+#include "frame_timing.hpp"
+#include "game.hpp"
+#include "input_replay.hpp"
+#include "perf_counters.hpp"
+#include "replication.hpp"
+#include "scenario.hpp"
+#include "soft_raster.hpp"
+#include "state_export.hpp"
+#include "stats.hpp"
+
+/// @brief Command line options of the headless driver
+struct HeadlessOptions {
+    int ticks = 600;
+    int width = 600;
+    int height = 600;
+    unsigned threads = 0;
+    /// @brief Write every Nth frame as a PPM image; 0 disables frame dumps
+    int dumpEvery = 0;
+    std::string outputDirectory = ".";
+    /// @brief Write the per-phase timing history of the last frames as JSON; empty disables
+    std::string timingsPath;
+    /// @brief Record profiler zones of the whole run as a Chrome trace; empty disables
+    std::string tracePath;
+    /// @brief Frames slower than this dump the timing history to --out; 0 disables
+    double hitchMilliseconds = 0.0;
+    /// @brief Count hardware events per phase with perf_event_open (Linux)
+    bool counters = false;
+    /// @brief Seeded bullet field to start from instead of an empty game; 0 disables
+    int bullets = 0;
+    /// @brief Write the (idle) input of every tick and periodic state hashes; empty disables
+    std::string recordPath;
+    /// @brief Play a recording to its end instead of running --ticks idle ticks; empty disables
+    std::string replayPath;
+    int hashInterval = 60;
+    /// @brief Publish every tick into this POSIX shared memory object; empty disables
+    std::string exportName;
+    /// @brief Stream state deltas to spectators on this UDP port, paced to real time; 0 disables
+    int servePort = 0;
+};
+
+void printUsage(const char *program) {
+    std::cerr << "Usage: " << program
+              << " [--ticks N] [--size WxH] [--threads N] [--dump-every N] [--out DIR]"
+                 " [--timings FILE] [--trace FILE] [--hitch-ms N]"
+                 " [--counters] [--bullets N] [--record FILE] [--replay FILE]"
+                 " [--hash-every N] [--export [NAME]] [--serve [PORT]]\n";
+}
+
+bool parseOptions(int argc, char **argv, HeadlessOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--ticks" && hasValue) {
+            options.ticks = std::atoi(argv[++i]);
+        } else if (arg == "--size" && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2)
+                return false;
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--dump-every" && hasValue) {
+            options.dumpEvery = std::atoi(argv[++i]);
+        } else if (arg == "--out" && hasValue) {
+            options.outputDirectory = argv[++i];
+        } else if (arg == "--timings" && hasValue) {
+            options.timingsPath = argv[++i];
+        } else if (arg == "--trace" && hasValue) {
+            options.tracePath = argv[++i];
+        } else if (arg == "--hitch-ms" && hasValue) {
+            options.hitchMilliseconds = std::atof(argv[++i]);
+        } else if (arg == "--counters") {
+            options.counters = true;
+        } else if (arg == "--bullets" && hasValue) {
+            options.bullets = std::atoi(argv[++i]);
+        } else if (arg == "--record" && hasValue) {
+            options.recordPath = argv[++i];
+        } else if (arg == "--replay" && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (arg == "--hash-every" && hasValue) {
+            options.hashInterval = std::atoi(argv[++i]);
+        } else if (arg == "--export") {
+            // The name is optional
+            bool hasName = hasValue && argv[i + 1][0] == '/';
+            options.exportName = hasName ? argv[++i] : shared_state::DEFAULT_NAME;
+        } else if (arg == "--serve") {
+            bool hasPort = hasValue && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]));
+            options.servePort = hasPort ? std::atoi(argv[++i]) : replication::DEFAULT_PORT;
+        } else {
+            return false;
+        }
+    }
+    return options.ticks > 0 && options.width > 0 && options.height > 0 &&
+           options.servePort >= 0 && options.servePort <= 65535;
+}
+
+int main(int argc, char **argv) {
+    HeadlessOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    GameState gameState(100, 500);
+    if (options.bullets > 0)
+        populateBulletField(gameState, options.bullets, options.bullets / 10, 1);
+
+    // A replay only reproduces the run if it starts from the same state, i.e. the same --bullets
+    InputRecorder inputRecorder;
+    InputReplay inputReplay;
+    bool replaying = !options.replayPath.empty();
+    if (!options.recordPath.empty() &&
+        !inputRecorder.open(options.recordPath, options.hashInterval)) {
+        std::cerr << "Failed to open " << options.recordPath << " for recording\n";
+        return 1;
+    }
+    if (replaying && !inputReplay.open(options.replayPath)) {
+        std::cerr << "Failed to load replay " << options.replayPath << ": "
+                  << inputReplay.error() << '\n';
+        return 1;
+    }
+    bool replayMatched = true;
+
+    StateExporter stateExporter;
+    if (!options.exportName.empty() && !stateExporter.open(options.exportName)) {
+        std::cerr << "Failed to export state: " << stateExporter.error() << '\n';
+        return 1;
+    }
+    ReplicationServer replicationServer;
+    if (options.servePort != 0 &&
+        !replicationServer.open(static_cast<std::uint16_t>(options.servePort))) {
+        std::cerr << "Failed to serve spectators: " << replicationServer.error() << '\n';
+        return 1;
+    }
+    Stats stats;
+    // Per-tick scratch (the render queue) is bump-allocated and dropped at the end of the tick
+    FrameArena frameArena;
+    SoftRasterizer rasterizer(options.width, options.height, options.threads);
+
+    if (!options.tracePath.empty()) {
+        if (!PROFILER_ENABLED)
+            std::cerr << "Profiler zones are compiled out; configure with -DPROFILER=ON\n";
+        profilerStart();
+    }
+
+    PerfCounters perfCounters;
+    PhaseCounters phaseCounters;
+    if (options.counters && !perfCounters.open())
+        std::cerr << "Hardware counters unavailable: " << perfCounters.reason() << '\n';
+
+    FrameTimings frameTimings;
+    FrameStats frameStats;
+    frameStats.hitchThresholdMilliseconds = options.hitchMilliseconds;
+    frameStats.hitchDirectory = options.outputDirectory;
+    std::array<double, PHASE_COUNT> totalMilliseconds{};
+    long long drawnTotal = 0;
+    AllocationCounters allocationsBefore = allocationTotals();
+
+    auto runStart = std::chrono::steady_clock::now();
+    int tick = 0;
+    for (; replaying || tick < options.ticks; tick++) {
+        TickInput input;
+        if (replaying && !inputReplay.next(input)) {
+            replayMatched = inputReplay.error().empty();
+            break;
+        }
+        if (inputRecorder.enabled())
+            inputRecorder.record(input);
+        auto frameStart = std::chrono::steady_clock::now();
+
+        {
+            ScopedCpuTimer phaseTimer(frameTimings, Phase::Update);
+            ScopedPhaseCounters phaseCounter(perfCounters, phaseCounters, Phase::Update);
+            applyInput(gameState, input);
+            updateGame(gameState, tickTime(tick));
+        }
+        {
+            ScopedCpuTimer phaseTimer(frameTimings, Phase::Collision);
+            ScopedPhaseCounters phaseCounter(perfCounters, phaseCounters, Phase::Collision);
+            countHits(gameState);
+        }
+        if (inputRecorder.enabled())
+            inputRecorder.afterTick(tick + 1, gameState);
+        if (replaying && !inputReplay.afterTick(tick + 1, gameState)) {
+            replayMatched = false;
+            break;
+        }
+        if (stateExporter.enabled()) {
+            ScopedCpuTimer phaseTimer(frameTimings, Phase::Export);
+            stateExporter.publish(tick + 1, gameState);
+        }
+        if (replicationServer.enabled()) {
+            ScopedCpuTimer phaseTimer(frameTimings, Phase::Export);
+            replicationServer.publish(tick + 1, tickTime(tick), gameState);
+            if ((tick + 1) % (1000 / TICK_MS) == 0)
+                replicationServer.writeReport(std::cout, tick + 1);
+        }
+        frameStats.recordTick(std::chrono::duration<double, std::milli>(
+                                  std::chrono::steady_clock::now() - frameStart)
+                                  .count());
+        {
+            ScopedCpuTimer phaseTimer(frameTimings, Phase::RenderPrep);
+            ScopedPhaseCounters phaseCounter(perfCounters, phaseCounters, Phase::RenderPrep);
+            frameArena.reset();
+            RenderQueue renderQueue(&frameArena);
+            renderQueue.reserve(submitCapacity(gameState));
+            RenderContext context(gameState.cameraOffset, renderQueue);
+            stats.beginFrame();
+            submitGame(gameState, context, stats);
+            renderQueue.sort();
+
+            rasterizer.clear(glm::fvec3(0.0f));
+            rasterizer.setViewProjection(context.viewProjection);
+            executeRenderQueue(renderQueue, rasterizer);
+        }
+        {
+            // The software equivalent of presenting: rasterize everything submitted this frame
+            ScopedCpuTimer phaseTimer(frameTimings, Phase::Present);
+            ScopedPhaseCounters phaseCounter(perfCounters, phaseCounters, Phase::Present);
+            rasterizer.flush();
+        }
+        frameTimings.commitFrame();
+        phaseCounters.addBullets(gameState.enemyBulletObjects.size() +
+                                 gameState.playerBulletObjects.size());
+        AllocationCounters allocationsNow = allocationTotals();
+        stats.allocations = (allocationsNow - allocationsBefore).allocations;
+        stats.allocatedBytes = (allocationsNow - allocationsBefore).bytes;
+        allocationsBefore = allocationsNow;
+        frameStats.recordFrame(std::chrono::duration<double, std::milli>(
+                                   std::chrono::steady_clock::now() - frameStart)
+                                   .count(),
+                               frameTimings);
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            totalMilliseconds[phase] += frameTimings.frame(0)[phase];
+        }
+        drawnTotal += stats.drawn;
+
+        if (options.dumpEvery > 0 && tick % options.dumpEvery == 0) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "/frame_%05d.ppm", tick);
+            if (!rasterizer.writePpm(options.outputDirectory + name)) {
+                std::cerr << "Failed to write " << options.outputDirectory + name << '\n';
+                return 1;
+            }
+        }
+        // Spectators watch in real time, so do not run ahead of the clock while serving
+        if (replicationServer.enabled()) {
+            std::this_thread::sleep_until(runStart +
+                                          std::chrono::milliseconds((tick + 1) * TICK_MS));
+        }
+    }
+
+    inputRecorder.close();
+    if (tick == 0) {
+        std::cerr << "No ticks were simulated\n";
+        return 1;
+    }
+
+    double frames = tick;
+    double renderMilliseconds = totalMilliseconds[static_cast<int>(Phase::RenderPrep)] +
+                                totalMilliseconds[static_cast<int>(Phase::Present)];
+    std::cout << "[headless] " << tick << " ticks at " << options.width << 'x'
+              << options.height << " on " << rasterizer.threadCount() << " threads\n";
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        std::cout << "[headless] " << phaseName(static_cast<Phase>(phase)) << ": "
+                  << totalMilliseconds[phase] / frames << " ms/frame\n";
+    }
+    std::cout << "[headless] render: " << frames * 1000.0 / renderMilliseconds
+              << " fps, drawn: " << drawnTotal / frames << " objects/frame\n";
+    frameStats.printSummary(std::cout);
+    if (options.counters)
+        phaseCounters.print(std::cout, perfCounters);
+    if (ALLOC_TRACKER_ENABLED) {
+        std::cout << "[headless] allocations in the last frame: " << stats.allocations << " ("
+                  << stats.allocatedBytes << " bytes)\n";
+    }
+
+    if (!options.timingsPath.empty()) {
+        std::ofstream timings(options.timingsPath);
+        frameTimings.writeJson(timings);
+    }
+    if (!options.tracePath.empty()) {
+        profilerStop();
+        std::ofstream trace(options.tracePath);
+        writeChromeTrace(trace);
+    }
+    if (replaying) {
+        if (!replayMatched) {
+            std::cerr << "[headless] replay diverged: " << inputReplay.error() << '\n';
+            return 1;
+        }
+        std::cout << "[headless] replay matched " << inputReplay.hashesChecked()
+                  << " state hashes\n";
+    }
+    return 0;
+}
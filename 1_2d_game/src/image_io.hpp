@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/// @brief Pack an 8-bit RGBA color the way framebuffers in this project store it
+inline std::uint32_t packRgba(std::uint8_t r, std::uint8_t g, std::uint8_t b,
+                              std::uint8_t a = 255) {
+    return static_cast<std::uint32_t>(r) | (static_cast<std::uint32_t>(g) << 8) |
+           (static_cast<std::uint32_t>(b) << 16) | (static_cast<std::uint32_t>(a) << 24);
+}
+
+/// @brief Write packed RGBA pixels as a binary PPM (P6) image, dropping alpha
+/// @param pixels width * height pixels, top row first unless bottomUp is set
+/// @param bottomUp true for bottom-row-first data such as glReadPixels output
+/// @return false if the file could not be written
+inline bool writePpm(const std::string &path, int width, int height, const std::uint32_t *pixels,
+                     bool bottomUp = false) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    file << "P6\n" << width << ' ' << height << "\n255\n";
+
+    std::vector<char> row(static_cast<std::size_t>(width) * 3);
+    for (int y = 0; y < height; y++) {
+        int sourceRow = bottomUp ? height - 1 - y : y;
+        const std::uint32_t *source = pixels + static_cast<std::size_t>(sourceRow) * width;
+        for (int x = 0; x < width; x++) {
+            row[x * 3 + 0] = static_cast<char>(source[x] & 0xFF);
+            row[x * 3 + 1] = static_cast<char>((source[x] >> 8) & 0xFF);
+            row[x * 3 + 2] = static_cast<char>((source[x] >> 16) & 0xFF);
+        }
+        file.write(row.data(), static_cast<std::streamsize>(row.size()));
+    }
+    return static_cast<bool>(file);
+}
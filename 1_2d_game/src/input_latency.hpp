@@ -0,0 +1,92 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "frame_stats.hpp"
+
+/// @brief Measures how long input events take to show up on screen
+/// @details Every event that changes the input is timestamped when the window system delivers it.
+/// When the input is sampled (by a simulation tick or a late latch) the pending events are bound
+/// to the next present, and at that present each event's age is recorded in
+/// FrameStats::inputLatency. FrameStats::inputWait holds the part spent before sampling. A late
+/// latch only shows some events early (movement, not attacks); it samples just those, and the
+/// others wait for the tick that consumes them.
+///
+/// "Present" is when the buffer swap returns, so scan-out and display latency are not included;
+/// neither is the time the event spent in the OS before reaching the window system callback.
+/// Storage is fixed; events beyond MAX_EVENTS in one frame are counted as dropped.
+class InputLatency {
+  public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t MAX_EVENTS = 64;
+
+    /// @brief An event that changes the input arrived
+    /// @param lateLatched A late latch shows the event before the simulation consumes it
+    void inputEvent(Clock::time_point time, bool lateLatched = false) {
+        if (pendingCount_ == MAX_EVENTS) {
+            dropped_++;
+            return;
+        }
+        pending_[pendingCount_++] = {time, lateLatched};
+    }
+
+    /// @brief The input was sampled; pending events become visible at the next present
+    void sampled(Clock::time_point time, FrameStats &frameStats) {
+        sample(time, frameStats, false);
+    }
+
+    /// @brief A late latch sampled the input; only the events it shows become visible at the next
+    /// present, the others stay pending
+    void lateLatched(Clock::time_point time, FrameStats &frameStats) {
+        sample(time, frameStats, true);
+    }
+
+    /// @brief A frame was presented, showing every event sampled before it
+    /// @return Number of events whose latency was recorded
+    std::size_t presented(Clock::time_point time, FrameStats &frameStats) {
+        std::size_t recorded = sampledCount_;
+        for (std::size_t i = 0; i < sampledCount_; i++) {
+            frameStats.inputLatency.record(milliseconds(time - sampled_[i]));
+        }
+        sampledCount_ = 0;
+        return recorded;
+    }
+
+    std::uint64_t dropped() const { return dropped_; }
+
+  private:
+    struct PendingEvent {
+        Clock::time_point time;
+        bool lateLatched = false;
+    };
+
+    static double milliseconds(Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    /// @param lateLatchedOnly Keep the events a late latch does not show pending, in order
+    void sample(Clock::time_point time, FrameStats &frameStats, bool lateLatchedOnly) {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < pendingCount_; i++) {
+            const PendingEvent &event = pending_[i];
+            if (lateLatchedOnly && !event.lateLatched) {
+                pending_[kept++] = event;
+                continue;
+            }
+            frameStats.inputWait.record(milliseconds(time - event.time));
+            if (sampledCount_ == MAX_EVENTS) {
+                dropped_++;
+                continue;
+            }
+            sampled_[sampledCount_++] = event.time;
+        }
+        pendingCount_ = kept;
+    }
+
+    std::array<PendingEvent, MAX_EVENTS> pending_{};
+    std::array<Clock::time_point, MAX_EVENTS> sampled_{};
+    std::size_t pendingCount_ = 0;
+    std::size_t sampledCount_ = 0;
+    std::uint64_t dropped_ = 0;
+};
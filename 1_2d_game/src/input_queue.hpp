@@ -0,0 +1,96 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include "game.hpp"
+
+/// @brief Bounded lock-free queue for one producer thread and one consumer thread
+/// @details push() may only be called by the producer and front()/pop() only by the consumer.
+/// Each side owns one index and publishes it with release stores, so neither ever blocks.
+/// @tparam Capacity Number of slots, a power of two
+template <typename T, std::size_t Capacity> class SpscQueue {
+    static_assert(std::has_single_bit(Capacity), "capacity must be a power of two");
+
+  public:
+    /// @return false if the queue is full; the item is not queued
+    bool push(const T &item) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity)
+            return false;
+        items_[tail & (Capacity - 1)] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Oldest item, or nullptr if the queue is empty; valid until pop()
+    const T *front() const {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return nullptr;
+        return &items_[head & (Capacity - 1)];
+    }
+
+    /// @brief Remove the oldest item
+    /// @return false if the queue is empty
+    bool pop() {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+  private:
+    // The indices only grow; keeping them on separate cache lines avoids false sharing
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::array<T, Capacity> items_{};
+};
+
+/// @brief A button going down or up, stamped with the time it happened
+struct InputEvent {
+    /// @brief Wall time in milliseconds, on the clock the simulation ticks are scheduled with
+    int timeMs = 0;
+    InputButton button = InputButton::Up;
+    bool pressed = false;
+};
+
+using InputEventQueue = SpscQueue<InputEvent, 256>;
+
+/// @brief Turns timestamped input events into the input of each simulation tick
+/// @details A tick sees every button that was held when it started or pressed before it ended.
+/// A tap that goes down and up between two ticks therefore still reaches exactly one tick, and
+/// which tick only depends on the event times, not on when the consumer happens to drain.
+class InputTimeline {
+  public:
+    /// @brief Consume the events up to the end of a tick and return the tick's input
+    /// @param tickEndMs Wall time the tick ends at; later events stay queued for later ticks
+    template <typename Queue> TickInput advance(Queue &queue, int tickEndMs) {
+        TickInput input = held_;
+        while (const InputEvent *event = queue.front()) {
+            if (event->timeMs > tickEndMs)
+                break;
+            auto bit = static_cast<std::uint8_t>(event->button);
+            if (event->pressed) {
+                held_.buttons |= bit;
+                input.buttons |= bit;
+            } else {
+                held_.buttons &= static_cast<std::uint8_t>(~bit);
+            }
+            queue.pop();
+        }
+        return input;
+    }
+
+    /// @brief Buttons held after the events consumed so far
+    TickInput held() const { return held_; }
+
+  private:
+    TickInput held_;
+};
@@ -0,0 +1,236 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "game.hpp"
+
+// Deterministic input recording and replay.
+//
+// A recording stores the TickInput of every simulation tick plus a hash of the GameState every N
+// ticks. Because the simulation only advances in fixed ticks, replaying the inputs reproduces the
+// game exactly, and the hashes tell at which point a replay diverged.
+//
+// File layout (little endian): the header "BHRP", u16 version, u16 tick length in ms, u32 hash
+// interval, then a sequence of records:
+//   0x01 u8 buttons, varint count  -- the same input held for count ticks
+//   0x02 varint tick, u64 hash     -- hashGameState() after simulating that many ticks
+
+/// @brief FNV-1a hash of every simulated field of the game
+inline std::uint64_t hashGameState(const GameState &gameState) {
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const auto &value) {
+        unsigned char bytes[sizeof(value)];
+        std::memcpy(bytes, &value, sizeof(value));
+        for (unsigned char byte : bytes) {
+            hash = (hash ^ byte) * 1099511628211ull;
+        }
+    };
+    auto mixVec2 = [&mix](glm::vec2 value) {
+        mix(value.x);
+        mix(value.y);
+    };
+
+    mix(gameState.health);
+    mix(gameState.bossHealth);
+    mixVec2(gameState.cameraOffset);
+    mixVec2(gameState.playerObject.currentPosition);
+    mix(gameState.playerObject.isBullet);
+    mix(gameState.playerObject.coolTime);
+    mixVec2(gameState.bossObject.currentPosition);
+    mix(gameState.bossObject.cooltime);
+    mix(gameState.playerBulletObjects.size());
+    for (const PlayerBullet &bullet : gameState.playerBulletObjects) {
+        mixVec2(bullet.currentPosition);
+        mix(bullet.initialTime);
+    }
+    mix(gameState.enemyBulletObjects.size());
+    for (const EnemyBullet &bullet : gameState.enemyBulletObjects) {
+        mixVec2(bullet.currentPosition);
+        mix(bullet.initialTime);
+    }
+    return hash;
+}
+
+namespace replay_format {
+constexpr char MAGIC[4] = {'B', 'H', 'R', 'P'};
+constexpr std::uint16_t VERSION = 1;
+constexpr std::uint8_t INPUT_RUN = 0x01;
+constexpr std::uint8_t STATE_HASH = 0x02;
+} // namespace replay_format
+
+/// @brief Writes the inputs of a play session, run-length encoded, with periodic state hashes
+class InputRecorder {
+  public:
+    /// @param hashInterval Write a state hash every this many ticks
+    bool open(const std::string &path, int hashInterval) {
+        file_.open(path, std::ios::binary);
+        hashInterval_ = hashInterval > 0 ? hashInterval : 60;
+        file_.write(replay_format::MAGIC, sizeof(replay_format::MAGIC));
+        writeInt<std::uint16_t>(replay_format::VERSION);
+        writeInt<std::uint16_t>(TICK_MS);
+        writeInt<std::uint32_t>(static_cast<std::uint32_t>(hashInterval_));
+        return static_cast<bool>(file_);
+    }
+    bool enabled() const { return file_.is_open(); }
+
+    /// @brief Record the input of the next tick
+    void record(TickInput input) {
+        if (runLength_ > 0 && input.buttons != runButtons_)
+            flushRun();
+        runButtons_ = input.buttons;
+        runLength_++;
+    }
+
+    /// @brief Call after simulating a tick; writes a hash when the tick is on the interval
+    /// @param tick Number of ticks simulated so far
+    void afterTick(int tick, const GameState &gameState) {
+        if (tick % hashInterval_ != 0)
+            return;
+        flushRun();
+        file_.put(static_cast<char>(replay_format::STATE_HASH));
+        writeVarint(static_cast<std::uint64_t>(tick));
+        writeInt<std::uint64_t>(hashGameState(gameState));
+    }
+
+    /// @brief Write the pending input run and close the file
+    void close() {
+        if (!enabled())
+            return;
+        flushRun();
+        file_.close();
+    }
+    ~InputRecorder() { close(); }
+
+  private:
+    void flushRun() {
+        if (runLength_ == 0)
+            return;
+        file_.put(static_cast<char>(replay_format::INPUT_RUN));
+        file_.put(static_cast<char>(runButtons_));
+        writeVarint(runLength_);
+        runLength_ = 0;
+    }
+    template <typename T> void writeInt(T value) {
+        for (std::size_t i = 0; i < sizeof(T); i++) {
+            file_.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+    void writeVarint(std::uint64_t value) {
+        do {
+            auto byte = static_cast<std::uint8_t>(value & 0x7F);
+            value >>= 7;
+            file_.put(static_cast<char>(value != 0 ? byte | 0x80 : byte));
+        } while (value != 0);
+    }
+
+    std::ofstream file_;
+    int hashInterval_ = 60;
+    std::uint8_t runButtons_ = 0;
+    std::uint64_t runLength_ = 0;
+};
+
+/// @brief Plays back a recording tick by tick and checks the state hashes it contains
+class InputReplay {
+  public:
+    /// @return false if the file is missing, truncated or not a recording
+    bool open(const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        data_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        position_ = 0;
+        if (data_.size() < 12 || std::memcmp(data_.data(), replay_format::MAGIC, 4) != 0) {
+            error_ = "missing or not a recording";
+            return false;
+        }
+        position_ = 4;
+        std::uint16_t version = readInt<std::uint16_t>();
+        std::uint16_t tickMs = readInt<std::uint16_t>();
+        readInt<std::uint32_t>();
+        if (version != replay_format::VERSION || tickMs != TICK_MS) {
+            error_ = "recording was made with a different format or tick length";
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Input of the next tick
+    /// @return false when the recording has no more ticks
+    bool next(TickInput &input) {
+        while (runLength_ == 0) {
+            if (!readRecord())
+                return false;
+        }
+        runLength_--;
+        input.buttons = runButtons_;
+        return true;
+    }
+
+    /// @brief Call after simulating a tick; compares the state with the recorded hash, if any
+    /// @return false on the first tick whose hash differs from the recording
+    bool afterTick(int tick, const GameState &gameState) {
+        // Hash records follow the input run of their tick, so read up to the next input
+        while (runLength_ == 0 && position_ < data_.size() &&
+               data_[position_] == replay_format::STATE_HASH) {
+            readRecord();
+        }
+        if (pendingHashTick_ != tick)
+            return true;
+        pendingHashTick_ = -1;
+        hashesChecked_++;
+        if (hashGameState(gameState) == pendingHash_)
+            return true;
+        error_ = "state hash mismatch at tick " + std::to_string(tick);
+        return false;
+    }
+
+    int hashesChecked() const { return hashesChecked_; }
+    const std::string &error() const { return error_; }
+
+  private:
+    bool readRecord() {
+        if (position_ >= data_.size())
+            return false;
+        std::uint8_t type = data_[position_++];
+        if (type == replay_format::INPUT_RUN) {
+            runButtons_ = position_ < data_.size() ? data_[position_++] : 0;
+            runLength_ = readVarint();
+            return true;
+        }
+        if (type == replay_format::STATE_HASH) {
+            pendingHashTick_ = static_cast<long long>(readVarint());
+            pendingHash_ = readInt<std::uint64_t>();
+            return true;
+        }
+        error_ = "corrupt recording";
+        position_ = data_.size();
+        return false;
+    }
+    template <typename T> T readInt() {
+        T value = 0;
+        for (std::size_t i = 0; i < sizeof(T) && position_ < data_.size(); i++) {
+            value |= static_cast<T>(static_cast<T>(data_[position_++]) << (8 * i));
+        }
+        return value;
+    }
+    std::uint64_t readVarint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; position_ < data_.size() && shift < 64; shift += 7) {
+            std::uint8_t byte = data_[position_++];
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                break;
+        }
+        return value;
+    }
+
+    std::vector<std::uint8_t> data_;
+    std::size_t position_ = 0;
+    std::uint8_t runButtons_ = 0;
+    std::uint64_t runLength_ = 0;
+    long long pendingHashTick_ = -1;
+    std::uint64_t pendingHash_ = 0;
+    int hashesChecked_ = 0;
+    std::string error_;
+};
@@ -3,280 +3,590 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
-#include <vector>
-#include "collision.hpp"
+#include <string>
+#include <utility>
+#include "alloc_tracker.hpp"
+#include "frame_arena.hpp"
+#include "frame_capture.hpp"
+#include "frame_pacer.hpp"
+#include "frame_stats.hpp"
+#include "frame_timing.hpp"
+#include "game.hpp"
+#include "gpu_timer.hpp"
+#include "input_latency.hpp"
+#include "input_queue.hpp"
+#include "input_replay.hpp"
+#include "profiler.hpp"
+#include "replication.hpp"
+#include "resolution_scaler.hpp"
+#include "scene_target.hpp"
+#include "state_export.hpp"
+#include "stats.hpp"
+#include "swap_control.hpp"
 #include "utils.hpp"
 
-/// @brief Interface for objects that can be drawn
-struct Drawable {
-    /// @brief Draw the object with a given camera camera_offset
-    /// @param camera_offset The camera offset to apply
-    virtual void draw(glm::vec2 camera_offset) = 0;
-    virtual ~Drawable() = default;
-};
-
 bool keyStates[256] = {false};
 
-struct GameState;
-
-/// @brief Interface for objects that can be updated
-struct Updatable {
-    /// @brief Update the object's state. Return true if the object should be removed.
-    /// @param deltaTime Time elapsed since the last update in milliseconds
-    /// @return true if the object should be removed
-    virtual bool update(int currentTime, GameState &gameState) = 0;
-    virtual ~Updatable() = default;
+GameState gameState(100, 500);
+Stats stats;
+/// @brief Holds each frame's render queue; reset at the start of the next frame
+FrameArena frameArena;
+GlStateCache glStateCache;
+/// @brief Backend executing the render queue, chosen with --backend or the b key
+RenderBackend renderBackend = RenderBackend::Immediate;
+LegacyRenderer legacyRenderer;
+FrameCapture frameCapture;
+FrameTimings frameTimings;
+FrameStats frameStats;
+GpuTimer gpuTimer;
+bool showOverlay = false;
+
+/// @brief Render with a hidden window, driving display() from the timer instead of GLUT
+bool offscreen = false;
+/// @brief Decides when the idle callback lets the next frame render
+FramePacer framePacer;
+/// @brief Refresh rate vsync pacing targets
+constexpr double DEFAULT_REFRESH_HZ = 60.0;
+/// @brief Builds the shader programs, through the binary cache set with --shader-cache
+ShaderManager shaderManager;
+/// @brief When main() was entered, for the startup time
+std::chrono::steady_clock::time_point startupBegin;
+/// @brief Offscreen target the scene is drawn into under dynamic resolution
+SceneTarget sceneTarget;
+/// @brief Picks the scale of sceneTarget from the measured render cost
+ResolutionScaler resolutionScaler;
+/// @brief Draw the scene at resolutionScaler's scale and upscale it to the window
+bool dynamicResolution = false;
+
+/// @brief Most ticks simulated per timer callback when catching up after a stall
+constexpr int MAX_TICKS_PER_CALLBACK = 8;
+/// @brief Number of simulation ticks run so far
+int simulatedTicks = 0;
+/// @brief GLUT time of the last timer callback, -1 before the first
+int lastTimerMs = -1;
+/// @brief Wall time not yet simulated, less than TICK_MS after every timer callback
+int pendingMs = 0;
+
+/// @brief Keys bound to the input buttons
+constexpr std::pair<unsigned char, InputButton> KEY_BINDINGS[] = {
+    {'w', InputButton::Up},    {'a', InputButton::Left},   {'s', InputButton::Down},
+    {'d', InputButton::Right}, {'e', InputButton::Attack}, // Attack also shakes the camera
 };
+/// @brief Bound key presses and releases, stamped with GLUT time, in the order they happened
+InputEventQueue inputEvents;
+/// @brief Applies each queued event at the tick its time falls in
+InputTimeline inputTimeline;
+/// @brief Input events lost because the queue was full
+unsigned long long droppedInputEvents = 0;
+/// @brief Timestamps input events and records when the frames showing them are presented
+InputLatency inputLatency;
+/// @brief Draw the player where the input held right before rendering moves it
+bool lateLatch = false;
+InputRecorder inputRecorder;
+InputReplay inputReplay;
+/// @brief Take the input of every tick from inputReplay instead of the keyboard
+bool replaying = false;
+/// @brief Publishes every tick to shared memory when started with --export
+StateExporter stateExporter;
+/// @brief Streams state deltas to spectators when started with --serve
+ReplicationServer replicationServer;
+
+/// @brief Flush pending work and report frame statistics before the process exits
+void shutdown() {
+    frameCapture.finish();
+    inputRecorder.close();
+    stateExporter.close();
+    if (replicationServer.enabled())
+        replicationServer.writeReport(std::cout, simulatedTicks);
+    replicationServer.close();
+    frameStats.printSummary(std::cout);
+    framePacer.printSummary(std::cout);
+    std::ofstream summary("frame_stats.json");
+    frameStats.writeJson(summary);
+}
 
-struct EnemyBullet : Updatable, Drawable, Collidable {
-    glm::fvec2 initialDirection;
-    glm::fvec2 normalDirection;
-    glm::fvec2 initialPosition;
-    glm::fvec2 currentPosition;
-    int initialTime;
-    float speed;
-
-    EnemyBullet(glm::fvec2 initialDirection, glm::fvec2 initialPosition, float speed,
-                int initialTime)
-        : initialDirection(glm::normalize(initialDirection) * speed),
-          normalDirection(glm::normalize(glm::fvec2(-initialDirection.y, initialDirection.x))),
-          initialPosition(initialPosition), currentPosition(initialPosition),
-          initialTime(initialTime), speed(speed) {}
-    ~EnemyBullet() override {}
-
-    float pos(int t) {
-        float deltaX = static_cast<float>(t) * speed; // f/ms
-        return std::sqrt(deltaX);
-    }
-    bool update(int currentTime, GameState &gameState) override {
-        int dt = currentTime - initialTime;
-        currentPosition =
-            initialPosition + float(dt) * initialDirection + pos(dt) * normalDirection;
-        return abs(currentPosition.x) > 1.0f || abs(currentPosition.y) > 1.0f;
-    }
-    void draw(glm::fvec2 cameraOffset) override {
-        drawCircle(currentPosition - cameraOffset, 0.03f, 10, glm::fvec3(1.0f, 1.0f, 1.0f));
-    }
-    CollisionShape getShape() const override {
-        return CollisionCircle(glm::vec2(0.0f, 0.0f), 1.0f);
+/// @brief Queue a press or release of a bound key; other keys are ignored
+void queueKeyEvent(unsigned char key, bool pressed) {
+    for (auto [boundKey, button] : KEY_BINDINGS) {
+        if (boundKey != key)
+            continue;
+        if (!inputEvents.push({glutGet(GLUT_ELAPSED_TIME), button, pressed}))
+            droppedInputEvents++;
+        // The late latch shows movement right away; attacks wait for the simulation
+        inputLatency.inputEvent(std::chrono::steady_clock::now(), button != InputButton::Attack);
     }
-};
-
-struct PlayerBullet : Updatable, Drawable, Collidable {
-    glm::fvec2 initialPosition;
-    glm::fvec2 currentPosition;
-    int initialTime;
-    float speed;
-
-    PlayerBullet(glm::fvec2 initialPosition, float speed, int initialTime)
-        : initialPosition(initialPosition), currentPosition(initialPosition),
-          initialTime(initialTime), speed(speed) {}
-    ~PlayerBullet() override {}
+}
 
-    bool update(int currentTime, GameState &gameState) override {
-        currentPosition =
-            initialPosition + glm::fvec2(0, speed * static_cast<float>(currentTime - initialTime));
-        return abs(currentPosition.x) > 1.0f || abs(currentPosition.y) > 1.0f;
-        ;
+/// @brief Buttons held on the keyboard right now
+TickInput heldButtons() {
+    TickInput input;
+    for (auto [key, button] : KEY_BINDINGS) {
+        if (keyStates[key])
+            input.press(button);
     }
-    void draw(glm::fvec2 cameraOffset) override {
-        drawRect(currentPosition - cameraOffset, 0.03f, glm::fvec3(1.0f, 0.0f, 1.0f));
-    }
-    CollisionShape getShape() const override {
-        return CollisionCircle(glm::vec2(0.0f, 0.0f), 1.0f);
-    }
-};
+    return input;
+}
 
-struct Player : Updatable, Drawable, Collidable {
-    glm::fvec2 currentPosition;
-    bool isBullet = false;
-    int coolTime = 0;
+/// @brief Turn dynamic resolution on or off; it starts over at full scale when turned on
+void setDynamicResolution(bool enabled) {
+    if (enabled && !sceneTarget.enabled()) {
+        std::cout << "Dynamic resolution needs framebuffer objects\n";
+        return;
+    }
+    dynamicResolution = enabled;
+    resolutionScaler = ResolutionScaler(resolutionScaler.config());
+    stats.resolutionScale = enabled ? resolutionScaler.scale() : 0.0f;
+    stats.resolutionChanges = 0;
+    std::cout << "Dynamic resolution " << (enabled ? "on" : "off") << '\n';
+}
 
-    Player(glm::fvec2 initialPosition) : currentPosition(initialPosition) {}
-    ~Player() override {}
+/// @brief Feed the render cost of a frame to the scaler and log any scale change
+void updateResolutionScale(double costMilliseconds) {
+    if (!resolutionScaler.record(costMilliseconds))
+        return;
+    const ResolutionScaler::Decision &decision = resolutionScaler.lastDecision();
+    stats.resolutionScale = decision.to;
+    stats.resolutionChanges = resolutionScaler.changes();
+    stats.lastResolutionChange = decision;
+    std::printf("Resolution scale %.0f%% -> %.0f%% (frames averaged %.2f ms)\n",
+                decision.from * 100.0f, decision.to * 100.0f, decision.averageMilliseconds);
+}
 
-    void tryAttack() { isBullet = true; }
-    bool update(int currentTime, GameState &gameState) override;
-    void draw(glm::fvec2 cameraOffset) override {
-        drawTriangle(currentPosition - cameraOffset, 0.1f, glm::fvec3(1.0f, 1.0f, 0.0f));
+void keyboardDown(unsigned char key, int /*x*/, int /*y*/) {
+    // Key repeat does not change the input, so only the first press is an input event
+    if (!keyStates[key])
+        queueKeyEvent(key, true);
+    keyStates[key] = true;
+    if (key == 'i') {
+        stats.print(std::cout);
     }
-    void move(glm::fvec2 deltaPosition) {
-        currentPosition += deltaPosition;
-
-        // Clamp
-        if (currentPosition.x < -1.0f)
-            currentPosition.x = -1.0f;
-        if (currentPosition.x > 1.0f)
-            currentPosition.x = 1.0f;
-        if (currentPosition.y < -1.0f)
-            currentPosition.y = -1.0f;
-        if (currentPosition.y > 1.0f)
-            currentPosition.y = 1.0f;
+    if (key == 'o') {
+        showOverlay = !showOverlay;
     }
-    CollisionShape getShape() const override {
-        return CollisionCircle(glm::vec2(0.0f, 0.0f), 1.0f);
+    if (key == 't') {
+        std::ofstream csv("frame_timings.csv");
+        frameTimings.writeCsv(csv);
+        std::ofstream json("frame_timings.json");
+        frameTimings.writeJson(json);
+        std::cout << "Frame timings written to frame_timings.csv and frame_timings.json\n";
     }
-};
-
-struct Boss : Updatable, Drawable, Collidable {
-    glm::fvec2 currentPosition;
-    int cooltime = 0;
-
-    Boss(glm::fvec2 initialPosition) : currentPosition(initialPosition) {}
-    ~Boss() override {}
-
-    bool update(int currentTime, GameState &gameState) override;
-    void draw(glm::fvec2 cameraOffset) override {
-        drawCircle(currentPosition - cameraOffset, 0.05f, 20, glm::fvec3(0.1f, 0.0f, 1.0f));
+    if (key == 'h') {
+        frameStats.printSummary(std::cout);
+        framePacer.printSummary(std::cout);
     }
-    CollisionShape getShape() const override {
-        return CollisionCircle(glm::vec2(0.0f, 0.0f), 1.0f);
+    if (key == 'l') {
+        lateLatch = !lateLatch;
+        std::cout << "Late latch " << (lateLatch ? "on" : "off") << '\n';
     }
-};
-
-struct Hearts : Drawable {
-    glm::fvec2 drawPosition;
-
-    Hearts(glm::fvec2 drawPosition) : drawPosition(drawPosition) {}
-    ~Hearts() override {}
-
-    void draw(glm::fvec2 cameraOffset) override {}
-};
-
-struct BossHealthBar : Drawable {
-    glm::fvec2 drawPosition;
-
-    BossHealthBar(glm::fvec2 drawPosition) : drawPosition(drawPosition) {}
-    ~BossHealthBar() override {}
-
-    void draw(glm::fvec2 cameraOffset) override {}
-};
-
-struct GameState {
-    GameState(int h, int bh)
-        : health(h), bossHealth(bh), cameraOffset(0.0f, 0.0f), playerObject(glm::fvec2(0.0f, 0.0f)),
-          bossObject(glm::fvec2(0.0f, 0.0f)), bossHealthBarObject(glm::fvec2(0.0f, 0.0f)),
-          heartsObject(glm::fvec2(0.0f, 0.0f)) {}
-
-    int health;
-    int bossHealth;
-    glm::fvec2 cameraOffset;
-
-    Player playerObject;
-    Boss bossObject;
-    BossHealthBar bossHealthBarObject;
-    Hearts heartsObject;
-
-    std::vector<PlayerBullet> playerBulletObjects;
-    std::vector<EnemyBullet> enemyBulletObjects;
-};
-
-bool Player::update(int currentTime, GameState &gameState) {
-    if (currentTime >= this->coolTime && this->isBullet) {
-        gameState.playerBulletObjects.emplace_back(this->currentPosition, 0.001f, currentTime);
-        this->isBullet = false;
-        this->coolTime = currentTime + 200;
+    if (key == 'b') {
+        renderBackend = static_cast<RenderBackend>((static_cast<int>(renderBackend) + 1) % 3);
+        std::cout << "Render backend: " << renderBackendName(renderBackend) << '\n';
+    }
+    if (key == 'r') {
+        setDynamicResolution(!dynamicResolution);
+    }
+    if (key == 'p') {
+        if (!PROFILER_ENABLED) {
+            std::cout << "Profiler zones are compiled out; configure with -DPROFILER=ON\n";
+        } else if (!profilerRecording()) {
+            profilerStart();
+            std::cout << "Profiler session started\n";
+        } else {
+            profilerStop();
+            std::ofstream trace("profile_trace.json");
+            std::size_t events = writeChromeTrace(trace);
+            std::cout << "Profiler session written to profile_trace.json (" << events
+                      << " events)\n";
+        }
     }
-    return false;
+}
+void keyboardUp(unsigned char key, int /*x*/, int /*y*/) {
+    if (keyStates[key])
+        queueKeyEvent(key, false);
+    keyStates[key] = false;
 }
 
-bool Boss::update(int currentTime, GameState &gameState) {
-    if (this->cooltime > currentTime)
-        return false;
-    this->cooltime = currentTime + 200;
-
-    EnemyBullet testBullet1(glm::fvec2(1.0f, 0.0f), glm::fvec2(0.0f, 0.0f), 0.001f, currentTime);
-    EnemyBullet testBullet2(glm::fvec2(1.0f, 0.0f), glm::fvec2(0.0f, 0.0f), 0.002f, currentTime);
-    gameState.enemyBulletObjects.push_back(testBullet1);
-    gameState.enemyBulletObjects.push_back(testBullet2);
+/// @brief Draw the stats surface and phase timings as text in the top-left corner
+void drawOverlay() {
+    int width = glutGet(GLUT_WINDOW_WIDTH);
+    int height = glutGet(GLUT_WINDOW_HEIGHT);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0.0, width, 0.0, height, -1.0, 1.0);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glColor3f(0.0f, 1.0f, 0.0f);
+
+    float y = static_cast<float>(height) - 16.0f;
+    auto printLine = [&y](const char *text) {
+        glRasterPos2f(8.0f, y);
+        glutBitmapString(GLUT_BITMAP_8_BY_13, reinterpret_cast<const unsigned char *>(text));
+        y -= 15.0f;
+    };
+
+    char line[96];
+    std::snprintf(line, sizeof(line), "drawn %d  culled %d  batches %d  binds %d  (%s)",
+                  stats.drawn, stats.culled, stats.batches, stats.programBinds,
+                  renderBackendName(renderBackend));
+    printLine(line);
+    if (ALLOC_TRACKER_ENABLED) {
+        std::snprintf(line, sizeof(line), "allocations %llu  bytes %llu",
+                      static_cast<unsigned long long>(stats.allocations),
+                      static_cast<unsigned long long>(stats.allocatedBytes));
+        printLine(line);
+    }
+    std::snprintf(line, sizeof(line), "input latency p50 %.1f  p95 %.1f  p99 %.1f ms%s",
+                  stats.inputLatencyP50, stats.inputLatencyP95, stats.inputLatencyP99,
+                  lateLatch ? "  (late latch)" : "");
+    printLine(line);
+    std::snprintf(line, sizeof(line), "pacing %.0f fps%s  missed %lld",
+                  framePacer.targetFramesPerSecond(), framePacer.vsync() ? " vsync" : "",
+                  framePacer.missedFrames());
+    printLine(line);
+    if (dynamicResolution) {
+        const ResolutionScaler::Decision &last = stats.lastResolutionChange;
+        std::snprintf(line, sizeof(line),
+                      "resolution %.0f%% %dx%d  changes %d  last %.0f%%->%.0f%%",
+                      stats.resolutionScale * 100.0f, sceneTarget.scaledWidth(),
+                      sceneTarget.scaledHeight(), stats.resolutionChanges, last.from * 100.0f,
+                      last.to * 100.0f);
+        printLine(line);
+    }
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        std::snprintf(line, sizeof(line), "%-12s avg %7.3f ms  max %7.3f ms",
+                      phaseName(static_cast<Phase>(phase)),
+                      frameTimings.average(static_cast<Phase>(phase)),
+                      frameTimings.max(static_cast<Phase>(phase)));
+        printLine(line);
+    }
 
-    std::cout << currentTime << ", " << gameState.bossHealth << ", "
-              << gameState.enemyBulletObjects.size() << '\n';
-    return false;
+    glStateCache.invalidateColor();
 }
-GameState gameState(100, 500);
-
-void keyboardDown(unsigned char key, int /*x*/, int /*y*/) { keyStates[key] = true; }
-void keyboardUp(unsigned char key, int /*x*/, int /*y*/) { keyStates[key] = false; }
 
 void display() {
+    PROFILE_ZONE("display");
+    double gpuMilliseconds = 0.0;
+    if (gpuTimer.poll(gpuMilliseconds)) {
+        frameTimings.add(Phase::Gpu, gpuMilliseconds);
+        // A few frames old, but it covers the rasterization the scale changes
+        if (dynamicResolution)
+            updateResolutionScale(gpuMilliseconds);
+    }
+
+    if (frameCapture.enabled()) {
+        frameCapture.beginFrame();
+    }
+    if (dynamicResolution) {
+        sceneTarget.begin(resolutionScaler.scale());
+    }
+    gpuTimer.begin();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    for (auto &object : gameState.enemyBulletObjects) {
-        object.draw(gameState.cameraOffset);
+    // Late latch: sample the keys as late as possible and draw the player where they move it
+    // during the current tick. The simulation only sees the keys at the next tick.
+    glm::vec2 simulatedPlayerPosition = gameState.playerObject.currentPosition;
+    if (lateLatch && !replaying) {
+        ScopedCpuTimer phaseTimer(frameTimings, Phase::Input);
+        int sinceTick = std::clamp(pendingMs + glutGet(GLUT_ELAPSED_TIME) - lastTimerMs, 0,
+                                   TICK_MS);
+        gameState.playerObject.currentPosition =
+            latchedPlayerPosition(gameState, heldButtons(), sinceTick);
+        inputLatency.lateLatched(std::chrono::steady_clock::now(), frameStats);
+    }
+
+    frameArena.reset();
+    RenderQueue renderQueue(&frameArena);
+    renderQueue.reserve(submitCapacity(gameState));
+    RenderContext context(gameState.cameraOffset, renderQueue);
+    auto renderStart = std::chrono::steady_clock::now();
+    {
+        ScopedCpuTimer phaseTimer(frameTimings, Phase::RenderPrep);
+        stats.beginFrame();
+
+        submitGame(gameState, context, stats);
+        gameState.playerObject.currentPosition = simulatedPlayerPosition;
+
+        renderQueue.sort();
+        glStateCache.resetCounters();
+        applyRenderContext(context, glStateCache);
+        executeRenderQueue(renderQueue, glStateCache, renderBackend, legacyRenderer);
+        stats.programBinds = glStateCache.programBinds;
+        stats.colorChanges = glStateCache.colorChanges;
+        stats.batches = glStateCache.batches;
     }
-    for (auto &object : gameState.playerBulletObjects) {
-        object.draw(gameState.cameraOffset);
+    gpuTimer.end();
+    if (dynamicResolution) {
+        // Without timer queries, the CPU time of drawing the scene stands in for its GPU time
+        if (!gpuTimer.supported())
+            updateResolutionScale(std::chrono::duration<double, std::milli>(
+                                      std::chrono::steady_clock::now() - renderStart)
+                                      .count());
+        // The overlay is drawn after the upscale, at full resolution
+        sceneTarget.resolve(frameCapture.enabled() ? frameCapture.framebuffer() : 0);
     }
-    gameState.playerObject.draw(gameState.cameraOffset);
-    gameState.bossObject.draw(gameState.cameraOffset);
 
-    glutSwapBuffers();
-    glutPostRedisplay();
+    if (showOverlay) {
+        drawOverlay();
+    }
+
+    {
+        ScopedCpuTimer phaseTimer(frameTimings, Phase::Present);
+        if (frameCapture.enabled()) {
+            frameCapture.endFrame(!offscreen);
+        }
+        if (!offscreen) {
+            glutSwapBuffers();
+        }
+    }
+    if (inputLatency.presented(std::chrono::steady_clock::now(), frameStats) > 0) {
+        stats.inputLatencyP50 = frameStats.inputLatency.percentileMilliseconds(0.50);
+        stats.inputLatencyP95 = frameStats.inputLatency.percentileMilliseconds(0.95);
+        stats.inputLatencyP99 = frameStats.inputLatency.percentileMilliseconds(0.99);
+    }
+    frameTimings.commitFrame();
+
+    static AllocationCounters lastFrameAllocations = allocationTotals();
+    AllocationCounters allocationsNow = allocationTotals();
+    AllocationCounters frameAllocations = allocationsNow - lastFrameAllocations;
+    lastFrameAllocations = allocationsNow;
+    stats.allocations = frameAllocations.allocations;
+    stats.allocatedBytes = frameAllocations.bytes;
+
+    // Present-to-present interval, so time spent outside display() counts as well
+    static auto lastPresent = std::chrono::steady_clock::now();
+    auto present = std::chrono::steady_clock::now();
+    if (frameStats.recordFrame(
+            std::chrono::duration<double, std::milli>(present - lastPresent).count(),
+            frameTimings)) {
+        std::cout << "Hitch detected, timing history written\n";
+    }
+    lastPresent = present;
+    framePacer.presented(present);
+
+    if (stats.startupMilliseconds == 0.0) {
+        stats.startupMilliseconds =
+            std::chrono::duration<double, std::milli>(present - startupBegin).count();
+        stats.shaderMilliseconds = shaderManager.milliseconds();
+        stats.shadersFromCache = shaderManager.cacheHits();
+        stats.shadersCompiled = shaderManager.compiled();
+        std::printf("Startup: %.1f ms to the first frame, shaders %.1f ms (%d from cache, %d "
+                    "compiled)\n",
+                    stats.startupMilliseconds, stats.shaderMilliseconds, stats.shadersFromCache,
+                    stats.shadersCompiled);
+    }
 }
 
-float playerSpeedBase = 0.0005f; // f/ms
+/// @brief Let GLUT render the next frame once the pacer says it is due
+/// @details Waits in slices of at most a millisecond so key events and the simulation timer are
+/// still handled (and timestamped) on time while waiting.
+void idle() {
+    if (framePacer.wait(std::chrono::milliseconds(1)))
+        glutPostRedisplay();
+}
 
-void keyInputUpdate(int dt) {
-    float playerSpeed = playerSpeedBase * static_cast<float>(dt);
+/// @brief Input of the tick ending at the given GLUT time, from the queued key events
+TickInput keyInputUpdate(int tickEndMs) {
     if (keyStates[27]) {
         std::cout << "ESC pressed -> exit\n";
+        shutdown();
         std::exit(0);
     }
-    if (keyStates['w']) {
-        gameState.playerObject.move(glm::vec2(0.0f, playerSpeed));
-        std::cout << "w clicked\n";
+    TickInput input = inputTimeline.advance(inputEvents, tickEndMs);
+    for (auto [key, button] : KEY_BINDINGS) {
+        if (input.held(button))
+            std::cout << key << " clicked\n";
+    }
+    // Events after the tick stay queued; bind them to a present only once a tick consumed them
+    if (inputEvents.empty())
+        inputLatency.sampled(std::chrono::steady_clock::now(), frameStats);
+    return input;
+}
+
+/// @brief Report the outcome of --replay and exit
+void finishReplay(bool matched) {
+    if (matched) {
+        std::cout << "Replay finished after " << simulatedTicks << " ticks, "
+                  << inputReplay.hashesChecked() << " state hashes matched\n";
+    } else {
+        std::cerr << "Replay diverged: " << inputReplay.error() << '\n';
     }
-    if (keyStates['a']) {
-        gameState.playerObject.move(glm::vec2(-playerSpeed, 0.0f));
-        std::cout << "a clicked\n";
+    shutdown();
+    std::exit(matched ? 0 : 1);
+}
+
+/// @brief Advance the simulation by one fixed tick
+/// @param tickEndMs GLUT time the tick ends at; key events up to then are applied to it
+void simulateTick(int tickEndMs) {
+    auto tickStart = std::chrono::steady_clock::now();
+    {
+        ScopedCpuTimer phaseTimer(frameTimings, Phase::Input);
+        TickInput input = keyInputUpdate(tickEndMs);
+        if (replaying && !inputReplay.next(input))
+            finishReplay(inputReplay.error().empty());
+        if (inputRecorder.enabled())
+            inputRecorder.record(input);
+        applyInput(gameState, input);
     }
-    if (keyStates['s']) {
-        gameState.playerObject.move(glm::vec2(0.0f, -playerSpeed));
-        std::cout << "s clicked\n";
+    {
+        ScopedCpuTimer phaseTimer(frameTimings, Phase::Update);
+        updateGame(gameState, tickTime(simulatedTicks));
     }
-    if (keyStates['d']) {
-        gameState.playerObject.move(glm::vec2(playerSpeed, 0.0f));
-        std::cout << "d clicked\n";
+    {
+        ScopedCpuTimer phaseTimer(frameTimings, Phase::Collision);
+        countHits(gameState);
     }
-    if (keyStates['e']) { // Camera Shake
-        gameState.playerObject.tryAttack();
-        std::cout << "e clicked\n";
+    simulatedTicks++;
+    if (inputRecorder.enabled())
+        inputRecorder.afterTick(simulatedTicks, gameState);
+    if (replaying && !inputReplay.afterTick(simulatedTicks, gameState))
+        finishReplay(false);
+    if (stateExporter.enabled()) {
+        ScopedCpuTimer phaseTimer(frameTimings, Phase::Export);
+        stateExporter.publish(simulatedTicks, gameState);
     }
+    if (replicationServer.enabled()) {
+        ScopedCpuTimer phaseTimer(frameTimings, Phase::Export);
+        replicationServer.publish(simulatedTicks, tickTime(simulatedTicks - 1), gameState);
+    }
+    frameStats.recordTick(
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tickStart)
+            .count());
 }
 
 void timer(int) {
-    static int lastMs = 0;
-
+    PROFILE_ZONE("timer");
     int now = glutGet(GLUT_ELAPSED_TIME); // Get Time in milliseconds.
-    if (lastMs == 0) {
-        lastMs = now;
+    if (lastTimerMs < 0) {
+        lastTimerMs = now;
     }
 
-    int dt = now - lastMs;
-    lastMs = now;
-
-    keyInputUpdate(dt);
-
-    std::erase_if(gameState.enemyBulletObjects,
-                  [&](auto &it) { return it.update(now, gameState); });
-
-    std::erase_if(gameState.playerBulletObjects,
-                  [&](auto &it) { return it.update(now, gameState); });
-
-    gameState.playerObject.update(now, gameState);
-    gameState.bossObject.update(now, gameState);
+    // The simulation advances in whole TICK_MS steps so that the same inputs always produce the
+    // same game; wall time only decides how many steps to run. After a long stall, drop the
+    // backlog instead of simulating it all at once. Each tick covers the TICK_MS of wall time
+    // ending at now - pendingMs and takes the key events stamped within it.
+    pendingMs = std::min(pendingMs + now - lastTimerMs, MAX_TICKS_PER_CALLBACK * TICK_MS);
+    lastTimerMs = now;
+    while (pendingMs >= TICK_MS) {
+        pendingMs -= TICK_MS;
+        simulateTick(now - pendingMs);
+    }
 
-    glutPostRedisplay();
-    glutTimerFunc(16, timer, 0);
+    // Windowed frames are released by idle(); offscreen ones follow the simulation
+    if (offscreen) {
+        display();
+    }
+    glutTimerFunc(TICK_MS, timer, 0);
 }
 
 int main(int argc, char **argv) {
+    startupBegin = std::chrono::steady_clock::now();
     glutInit(&argc, argv);
+
+    // Options left over after GLUT consumed its own
+    std::string captureDirectory;
+    int captureLag = 3;
+    std::string recordPath;
+    std::string replayPath;
+    int hashInterval = 60;
+    std::string exportName;
+    int servePort = 0;
+    std::string shaderCacheDirectory = "shader_cache";
+    // Negative: pace to the display refresh with vsync
+    double framesPerSecond = -1.0;
+    bool useDynamicResolution = false;
+    // Zero: three quarters of the frame period
+    double resolutionBudget = 0.0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--capture" && i + 1 < argc) {
+            captureDirectory = argv[++i];
+        } else if (arg == "--capture-lag" && i + 1 < argc) {
+            captureLag = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--fps" && i + 1 < argc) {
+            framesPerSecond = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--dynamic-resolution") {
+            // The budget is optional
+            bool hasBudget =
+                i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]));
+            if (hasBudget)
+                resolutionBudget = std::atof(argv[++i]);
+            useDynamicResolution = true;
+        } else if (arg == "--shader-cache" && i + 1 < argc) {
+            shaderCacheDirectory = argv[++i];
+        } else if (arg == "--no-shader-cache") {
+            shaderCacheDirectory.clear();
+        } else if (arg == "--backend" && i + 1 < argc) {
+            std::string name = argv[++i];
+            bool known = false;
+            for (RenderBackend backend : {RenderBackend::Immediate, RenderBackend::DisplayLists,
+                                          RenderBackend::VertexArrays}) {
+                if (name == renderBackendName(backend)) {
+                    renderBackend = backend;
+                    known = true;
+                }
+            }
+            if (!known) {
+                std::cerr << "Unknown backend: " << name << " (immediate, lists or arrays)\n";
+                return -1;
+            }
+        } else if (arg == "--late-latch") {
+            lateLatch = true;
+        } else if (arg == "--offscreen") {
+            offscreen = true;
+        } else if (arg == "--hitch-ms" && i + 1 < argc) {
+            frameStats.hitchThresholdMilliseconds = std::atof(argv[++i]);
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--hash-every" && i + 1 < argc) {
+            hashInterval = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--export") {
+            // The name is optional
+            bool hasName = i + 1 < argc && argv[i + 1][0] == '/';
+            exportName = hasName ? argv[++i] : shared_state::DEFAULT_NAME;
+        } else if (arg == "--serve") {
+            bool hasPort = i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]));
+            servePort = hasPort ? std::atoi(argv[++i]) : replication::DEFAULT_PORT;
+        } else {
+            std::cerr << "Unknown option: " << arg << '\n';
+            return -1;
+        }
+    }
+    if (!recordPath.empty() && !inputRecorder.open(recordPath, hashInterval)) {
+        std::cerr << "Failed to open " << recordPath << " for recording\n";
+        return -1;
+    }
+    if (!replayPath.empty()) {
+        if (!inputReplay.open(replayPath)) {
+            std::cerr << "Failed to load replay " << replayPath << ": " << inputReplay.error()
+                      << '\n';
+            return -1;
+        }
+        replaying = true;
+    }
+    if (!exportName.empty() && !stateExporter.open(exportName)) {
+        std::cerr << "Failed to export state: " << stateExporter.error() << '\n';
+        return -1;
+    }
+    if (servePort != 0 && !replicationServer.open(static_cast<std::uint16_t>(servePort))) {
+        std::cerr << "Failed to serve spectators: " << replicationServer.error() << '\n';
+        return -1;
+    }
+
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
     glutInitWindowSize(600, 600);
     glutCreateWindow("CSED451 Assn 1");
+    if (offscreen) {
+        glutHideWindow();
+    }
 
     // Test GLM properly linked
     glm::vec3 glmTest(1.0f, 0.0f, 0.0f);
@@ -287,11 +597,50 @@ int main(int argc, char **argv) {
         return -1;
     }
 
-    glEnable(GL_DEPTH_TEST);
+    // Everything lies at z = 0 and is drawn back to front, so there is nothing for a depth test to
+    // do; it would only let the transparent edges of SDF circles hide shapes drawn after them
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    shaderManager.setCacheDirectory(shaderCacheDirectory);
+    if (!initSdfCircles(shaderManager)) {
+        std::cerr << "SDF circle shader unavailable, falling back to triangle fans\n";
+    }
+    if (!gpuTimer.init()) {
+        std::cerr << "GPU timer queries unavailable, GPU time will read as zero\n";
+    }
+    if (!captureDirectory.empty() && !frameCapture.init(600, 600, captureLag, captureDirectory)) {
+        std::cerr << "Frame capture needs framebuffer and pixel buffer objects\n";
+        return -1;
+    }
+    // GLUT cannot query the refresh rate, so vsync pacing assumes DEFAULT_REFRESH_HZ. An explicit
+    // --fps cap is paced by sleeping instead, with swaps that do not wait.
+    bool vsync = framesPerSecond < 0.0 && setSwapInterval(1);
+    if (!vsync)
+        setSwapInterval(0);
+    framePacer.configure(framesPerSecond < 0.0 ? DEFAULT_REFRESH_HZ : framesPerSecond, vsync);
+
+    // The scene target is set up even without --dynamic-resolution, so the r key can turn it on
+    if (!sceneTarget.init(600, 600) && useDynamicResolution) {
+        std::cerr << "Dynamic resolution needs framebuffer objects\n";
+        return -1;
+    }
+    ResolutionScalerConfig resolutionConfig;
+    if (resolutionBudget > 0.0) {
+        resolutionConfig.budgetMilliseconds = resolutionBudget;
+    } else if (framePacer.targetFramesPerSecond() > 0.0) {
+        resolutionConfig.budgetMilliseconds = 750.0 / framePacer.targetFramesPerSecond();
+    }
+    resolutionScaler = ResolutionScaler(resolutionConfig);
+    if (useDynamicResolution)
+        setDynamicResolution(true);
 
     glutKeyboardFunc(keyboardDown);
     glutKeyboardUpFunc(keyboardUp);
     glutDisplayFunc(display);
+    if (!offscreen) {
+        glutIdleFunc(idle);
+    }
     glutTimerFunc(0, timer, 0);
 
     glutMainLoop();
@@ -0,0 +1,223 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include "frame_timing.hpp"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+/// @brief Hardware events counted per frame phase
+enum class PerfCounter : int { Cycles, Instructions, L1dMisses, LlcMisses, BranchMisses, Count };
+
+constexpr int PERF_COUNTER_COUNT = static_cast<int>(PerfCounter::Count);
+
+/// @brief Counter values at one point in time, scaled for multiplexing
+struct PerfSample {
+    std::array<double, PERF_COUNTER_COUNT> values{};
+
+    PerfSample operator-(const PerfSample &other) const {
+        PerfSample result;
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            result.values[i] = values[i] - other.values[i];
+        }
+        return result;
+    }
+};
+
+/// @brief Hardware performance counters of the calling thread, read through perf_event_open
+/// @details Linux only. Events the CPU or hypervisor does not expose are left out; when none can
+/// be opened (no PMU, perf_event_paranoid too strict, other platforms) the object stays
+/// unavailable, reads return zeros and reason() says why. Counts cover user space of the thread
+/// that called open(), not the rasterizer's worker threads.
+class PerfCounters {
+  public:
+    PerfCounters() { fds_.fill(-1); }
+    ~PerfCounters() { close(); }
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /// @brief Open and start the counters as one group
+    /// @return false if no counter could be opened; see reason()
+    bool open() {
+#ifdef __linux__
+        struct EventConfig {
+            std::uint32_t type;
+            std::uint64_t config;
+        };
+        constexpr std::uint64_t L1D_READ_MISS =
+            PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        const EventConfig EVENTS[PERF_COUNTER_COUNT] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, L1D_READ_MISS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        };
+
+        int firstError = 0;
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = EVENTS[i].type;
+            attr.config = EVENTS[i].config;
+            attr.disabled = leader_ < 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format =
+                PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+            if (fd < 0) {
+                firstError = firstError != 0 ? firstError : errno;
+                continue;
+            }
+            fds_[i] = fd;
+            groupIndex_[i] = groupSize_++;
+            if (leader_ < 0)
+                leader_ = fd;
+        }
+        if (leader_ < 0) {
+            reason_ = std::string("perf_event_open failed: ") + std::strerror(firstError);
+            if (firstError == EACCES || firstError == EPERM)
+                reason_ += " (check /proc/sys/kernel/perf_event_paranoid)";
+            return false;
+        }
+        ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        return true;
+#else
+        reason_ = "hardware counters are only supported on Linux";
+        return false;
+#endif
+    }
+
+    void close() {
+#ifdef __linux__
+        for (int &fd : fds_) {
+            if (fd >= 0)
+                ::close(fd);
+            fd = -1;
+        }
+#endif
+        leader_ = -1;
+        groupSize_ = 0;
+    }
+
+    bool available() const { return leader_ >= 0; }
+    /// @brief Whether a particular event is being counted
+    bool has(PerfCounter counter) const { return fds_[static_cast<int>(counter)] >= 0; }
+    /// @brief Why open() failed; empty when counters are available
+    const std::string &reason() const { return reason_; }
+
+    /// @brief Current values of every counter, one read() for the whole group
+    PerfSample read() const {
+        PerfSample sample;
+#ifdef __linux__
+        if (!available())
+            return sample;
+        // Layout of a PERF_FORMAT_GROUP read: nr, time_enabled, time_running, values[nr]
+        std::uint64_t buffer[3 + PERF_COUNTER_COUNT] = {};
+        if (::read(leader_, buffer, sizeof(buffer)) < static_cast<ssize_t>(3 * sizeof(buffer[0])))
+            return sample;
+        // Scale up when the kernel had to multiplex the group with other events
+        double scale = buffer[2] > 0 ? static_cast<double>(buffer[1]) / buffer[2] : 1.0;
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            if (fds_[i] >= 0)
+                sample.values[i] = static_cast<double>(buffer[3 + groupIndex_[i]]) * scale;
+        }
+#endif
+        return sample;
+    }
+
+  private:
+    std::array<int, PERF_COUNTER_COUNT> fds_;
+    std::array<int, PERF_COUNTER_COUNT> groupIndex_{};
+    int groupSize_ = 0;
+    int leader_ = -1;
+    std::string reason_;
+};
+
+/// @brief Counter totals per frame phase, reported as IPC and events per bullet
+class PhaseCounters {
+  public:
+    void add(Phase phase, const PerfSample &delta) {
+        PerfSample &total = totals_[static_cast<int>(phase)];
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            total.values[i] += delta.values[i];
+        }
+    }
+    /// @brief Count the bullets simulated in a frame, the denominator of the per-bullet figures
+    void addBullets(std::size_t count) { bullets_ += static_cast<double>(count); }
+
+    void print(std::ostream &out, const PerfCounters &counters) const {
+        if (!counters.available()) {
+            out << "[counters] unavailable: " << counters.reason() << '\n';
+            return;
+        }
+        char line[160];
+        std::snprintf(line, sizeof(line), "[counters] %-12s %8s %14s %14s %16s", "phase", "ipc",
+                      "l1d miss/blt", "llc miss/blt", "branch miss/blt");
+        out << line << '\n';
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            const PerfSample &total = totals_[phase];
+            auto value = [&](PerfCounter counter) {
+                return total.values[static_cast<int>(counter)];
+            };
+            auto perBullet = [&](PerfCounter counter) {
+                return ratio(counters.has(counter), value(counter), bullets_);
+            };
+            if (value(PerfCounter::Cycles) <= 0.0 && value(PerfCounter::Instructions) <= 0.0)
+                continue;
+            std::string ipc = ratio(counters.has(PerfCounter::Instructions) &&
+                                        counters.has(PerfCounter::Cycles),
+                                    value(PerfCounter::Instructions), value(PerfCounter::Cycles));
+            std::snprintf(line, sizeof(line), "[counters] %-12s %8s %14s %14s %16s",
+                          phaseName(static_cast<Phase>(phase)), ipc.c_str(),
+                          perBullet(PerfCounter::L1dMisses).c_str(),
+                          perBullet(PerfCounter::LlcMisses).c_str(),
+                          perBullet(PerfCounter::BranchMisses).c_str());
+            out << line << '\n';
+        }
+    }
+
+  private:
+    /// @brief numerator / denominator with three decimals, or n/a if it cannot be computed
+    static std::string ratio(bool counted, double numerator, double denominator) {
+        if (!counted || denominator <= 0.0)
+            return "n/a";
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.3f", numerator / denominator);
+        return text;
+    }
+
+    std::array<PerfSample, PHASE_COUNT> totals_{};
+    double bullets_ = 0.0;
+};
+
+/// @brief Adds the counter deltas of its scope to a phase; does nothing when counters are off
+class ScopedPhaseCounters {
+  public:
+    ScopedPhaseCounters(const PerfCounters &counters, PhaseCounters &phases, Phase phase)
+        : counters_(counters), phases_(phases), phase_(phase),
+          start_(counters.available() ? counters.read() : PerfSample{}) {}
+    ~ScopedPhaseCounters() {
+        if (counters_.available())
+            phases_.add(phase_, counters_.read() - start_);
+    }
+    ScopedPhaseCounters(const ScopedPhaseCounters &) = delete;
+    ScopedPhaseCounters &operator=(const ScopedPhaseCounters &) = delete;
+
+  private:
+    const PerfCounters &counters_;
+    PhaseCounters &phases_;
+    Phase phase_;
+    PerfSample start_;
+};
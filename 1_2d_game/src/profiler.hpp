@@ -0,0 +1,197 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include "alloc_tracker.hpp"
+#if defined(__x86_64__) || defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// Instrumentation profiler with per-thread event buffers and Chrome Trace Event export.
+//
+// Place PROFILE_ZONE("name") at the top of a scope to record it as one trace event. Zones are
+// compiled out entirely unless ENABLE_PROFILER is defined (CMake: -DPROFILER=ON). Names must be
+// string literals, or otherwise outlive the session.
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+constexpr bool PROFILER_ENABLED = true;
+#else
+#define PROFILE_ZONE(name) ((void)0)
+constexpr bool PROFILER_ENABLED = false;
+#endif
+
+/// @brief Raw timestamp: the TSC on x86-64, steady_clock nanoseconds elsewhere
+inline std::uint64_t profileTimestamp() {
+#if defined(__x86_64__) || defined(_M_X64)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now().time_since_epoch())
+                                          .count());
+#endif
+}
+
+inline std::int64_t profileSteadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// @brief A finished zone, in raw timestamp units
+struct ProfileEvent {
+    const char *name;
+    std::uint64_t start;
+    std::uint64_t end;
+    /// @brief Heap allocations made inside the zone, children included (see alloc_tracker.hpp)
+    std::uint32_t allocations;
+    std::uint32_t allocatedBytes;
+};
+
+/// @brief Events of one thread; only that thread appends, so no locking is needed
+/// @details count is published with release ordering after the event is written, so an exporter
+/// on another thread sees only complete events. When the buffer is full, new events are dropped.
+struct ProfileThreadBuffer {
+    static constexpr std::size_t CAPACITY = 1 << 16;
+
+    int threadId = 0;
+    std::atomic<std::size_t> count{0};
+    std::atomic<std::size_t> dropped{0};
+    std::array<ProfileEvent, CAPACITY> events{};
+
+    void append(const ProfileEvent &event) {
+        std::size_t index = count.load(std::memory_order_relaxed);
+        if (index >= CAPACITY) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events[index] = event;
+        count.store(index + 1, std::memory_order_release);
+    }
+};
+
+/// @brief Owns every thread buffer and the state of the current session
+struct ProfileRegistry {
+    std::atomic<bool> recording{false};
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ProfileThreadBuffer>> buffers;
+    std::uint64_t sessionStartTimestamp = 0;
+    std::int64_t sessionStartNanoseconds = 0;
+
+    /// @brief Buffer of the calling thread, registered on first use
+    ProfileThreadBuffer &threadBuffer() {
+        thread_local ProfileThreadBuffer *buffer = nullptr;
+        if (buffer == nullptr) {
+            // Do not charge the profiler's own buffer to the zone that happens to register it
+            AllocationCounters zoneAllocations = threadAllocations;
+            std::lock_guard lock(mutex);
+            buffers.push_back(std::make_unique<ProfileThreadBuffer>());
+            buffer = buffers.back().get();
+            buffer->threadId = static_cast<int>(buffers.size());
+            threadAllocations = zoneAllocations;
+        }
+        return *buffer;
+    }
+};
+
+inline ProfileRegistry profileRegistry;
+
+/// @brief Records the duration of its scope as one event while a session is recording
+class ProfileZone {
+  public:
+    explicit ProfileZone(const char *name)
+        : name_(profileRegistry.recording.load(std::memory_order_relaxed) ? name : nullptr),
+          startAllocations_(threadAllocations),
+          start_(name_ != nullptr ? profileTimestamp() : 0) {}
+    ~ProfileZone() {
+        if (name_ == nullptr)
+            return;
+        std::uint64_t end = profileTimestamp();
+        AllocationCounters allocated = threadAllocations - startAllocations_;
+        profileRegistry.threadBuffer().append({name_, start_, end,
+                                               static_cast<std::uint32_t>(allocated.allocations),
+                                               static_cast<std::uint32_t>(allocated.bytes)});
+    }
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator=(const ProfileZone &) = delete;
+
+  private:
+    const char *name_;
+    AllocationCounters startAllocations_;
+    std::uint64_t start_;
+};
+
+/// @brief Discard previous events and start recording zones
+/// @details Call between frames from the main thread; zones open at that moment may be lost.
+inline void profilerStart() {
+    std::lock_guard lock(profileRegistry.mutex);
+    for (auto &buffer : profileRegistry.buffers) {
+        buffer->count.store(0);
+        buffer->dropped.store(0);
+    }
+    profileRegistry.sessionStartTimestamp = profileTimestamp();
+    profileRegistry.sessionStartNanoseconds = profileSteadyNanoseconds();
+    profileRegistry.recording.store(true);
+}
+
+inline void profilerStop() { profileRegistry.recording.store(false); }
+
+inline bool profilerRecording() { return profileRegistry.recording.load(); }
+
+/// @brief Write the recorded session as Chrome Trace Event JSON (chrome://tracing, Perfetto)
+/// @return Number of events written
+inline std::size_t writeChromeTrace(std::ostream &out) {
+    std::lock_guard lock(profileRegistry.mutex);
+
+    // Convert raw timestamps to microseconds using the wall time elapsed since the session start
+    double elapsedTicks =
+        static_cast<double>(profileTimestamp() - profileRegistry.sessionStartTimestamp);
+    double elapsedNanoseconds =
+        static_cast<double>(profileSteadyNanoseconds() - profileRegistry.sessionStartNanoseconds);
+    double microsecondsPerTick =
+        elapsedTicks > 0.0 ? elapsedNanoseconds / elapsedTicks / 1000.0 : 0.001;
+    auto toMicroseconds = [&](std::uint64_t timestamp) {
+        return static_cast<double>(static_cast<std::int64_t>(
+                   timestamp - profileRegistry.sessionStartTimestamp)) *
+               microsecondsPerTick;
+    };
+
+    std::size_t written = 0;
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    for (const auto &buffer : profileRegistry.buffers) {
+        std::size_t count = buffer->count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; i++) {
+            const ProfileEvent &event = buffer->events[i];
+            out << (written > 0 ? ",\n" : "") << "{\"name\": \"" << event.name
+                << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->threadId
+                << ", \"ts\": " << toMicroseconds(event.start)
+                << ", \"dur\": " << toMicroseconds(event.end) - toMicroseconds(event.start);
+            if (event.allocations > 0) {
+                out << ", \"args\": {\"allocations\": " << event.allocations
+                    << ", \"bytes\": " << event.allocatedBytes << "}";
+            }
+            out << "}";
+            written++;
+        }
+        if (buffer->dropped.load() > 0) {
+            out << (written > 0 ? ",\n" : "")
+                << "{\"name\": \"dropped events\", \"ph\": \"C\", \"pid\": 1, \"ts\": 0, "
+                   "\"args\": {\"thread "
+                << buffer->threadId << "\": " << buffer->dropped.load() << "}}";
+            written++;
+        }
+    }
+    out << "\n]}\n";
+    return written;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// On-disk cache of linked shader program binaries.
+//
+// File layout (little endian): the header "BHPB", u16 version, u64 key, u32 binary format, u32
+// length, then length bytes as returned by glGetProgramBinary. The key hashes the shader sources
+// and the GL vendor, renderer and version strings, so editing a shader or updating the driver
+// misses the cache instead of loading a binary the driver would reject.
+
+namespace program_cache_format {
+constexpr char MAGIC[4] = {'B', 'H', 'P', 'B'};
+constexpr std::uint16_t VERSION = 1;
+constexpr std::size_t HEADER_SIZE = 4 + 2 + 8 + 4 + 4;
+} // namespace program_cache_format
+
+/// @brief A linked program as returned by glGetProgramBinary
+struct ProgramBinary {
+    std::uint32_t format = 0;
+    std::vector<std::uint8_t> data;
+};
+
+/// @brief FNV-1a hash of strings; each part is terminated, so moving text between parts changes it
+inline std::uint64_t programCacheKey(std::initializer_list<std::string_view> parts) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (std::string_view part : parts) {
+        for (char c : part) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        // A zero byte as terminator
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/// @brief Write a program binary under its key
+/// @details The file is written next to its destination and renamed over it, so a game starting
+/// at the same time never reads a half-written binary.
+inline bool writeProgramBinary(const std::string &path, std::uint64_t key,
+                               const ProgramBinary &binary) {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        auto writeInt = [&file](auto value) {
+            for (std::size_t i = 0; i < sizeof(value); i++) {
+                file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+            }
+        };
+        file.write(program_cache_format::MAGIC, sizeof(program_cache_format::MAGIC));
+        writeInt(program_cache_format::VERSION);
+        writeInt(key);
+        writeInt(binary.format);
+        writeInt(static_cast<std::uint32_t>(binary.data.size()));
+        file.write(reinterpret_cast<const char *>(binary.data.data()),
+                   static_cast<std::streamsize>(binary.data.size()));
+        if (!file)
+            return false;
+    }
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/// @brief Read a program binary written for the given key
+/// @return false if the file is missing, truncated, or was written for another key
+inline bool readProgramBinary(const std::string &path, std::uint64_t key, ProgramBinary &binary) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)),
+                                    std::istreambuf_iterator<char>());
+    if (bytes.size() < program_cache_format::HEADER_SIZE ||
+        std::memcmp(bytes.data(), program_cache_format::MAGIC, 4) != 0)
+        return false;
+
+    std::size_t position = 4;
+    auto readInt = [&bytes, &position](auto &value) {
+        value = 0;
+        for (std::size_t i = 0; i < sizeof(value); i++) {
+            value |= static_cast<std::remove_reference_t<decltype(value)>>(bytes[position++])
+                     << (8 * i);
+        }
+    };
+    std::uint16_t version = 0;
+    std::uint64_t storedKey = 0;
+    std::uint32_t length = 0;
+    readInt(version);
+    readInt(storedKey);
+    readInt(binary.format);
+    readInt(length);
+    if (version != program_cache_format::VERSION || storedKey != key ||
+        bytes.size() - position != length)
+        return false;
+    binary.data.assign(bytes.begin() + static_cast<std::ptrdiff_t>(position), bytes.end());
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <variant>
+#include "collision.hpp"
+#include "render_queue.hpp"
+
+/// @brief Build the world-to-clip transform for a camera looking at the [-1, 1] world box
+/// @param cameraOffset World position of the camera center
+inline glm::mat4 makeViewProjection(glm::vec2 cameraOffset) {
+    glm::mat4 projection = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f);
+    glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(-cameraOffset, 0.0f));
+    return projection * view;
+}
+
+/// @brief Per-frame rendering state handed to every Drawable
+struct RenderContext {
+    glm::vec2 cameraOffset;
+    glm::mat4 viewProjection;
+    /// @brief World-space rectangle covered by the view
+    CollisionRectangle viewRect;
+    /// @brief Queue that Drawables submit their draw commands to
+    RenderQueue &queue;
+
+    RenderContext(glm::vec2 cameraOffset, RenderQueue &queue)
+        : cameraOffset(cameraOffset), viewProjection(makeViewProjection(cameraOffset)),
+          viewRect(cameraOffset - glm::vec2(1.0f), cameraOffset + glm::vec2(1.0f)), queue(queue) {}
+
+    /// @brief Test whether the bounds of an object overlap the view
+    /// @param object The object to test, bounded by its collision shape
+    /// @return false if drawing the object cannot produce any visible pixel
+    template <CollidableObject T> bool isVisible(const T &object) const {
+        return std::visit([this](const auto &shape) { return shape.intersects(viewRect); },
+                          object.getShape());
+    }
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+/// @brief Draw order bucket, one per kind of drawable; higher layers are drawn later
+enum class Layer : std::uint8_t { EnemyBullets = 0, PlayerBullets = 1, Boss = 2, Player = 3 };
+
+/// @brief Shader program a command is drawn with
+enum class ShaderId : std::uint8_t { FixedFunction = 0, SdfCircle = 1 };
+
+/// @brief Shape emitted by a command
+enum class Primitive : std::uint8_t { Triangle = 0, Rect = 1, Circle = 2, SdfCircle = 3 };
+
+/// @brief Build a 64-bit sort key, most significant field first
+/// @details Layout: layer (63..56), shader (55..48), primitive (47..40). The layer fixes which
+/// drawables cover which, so within a layer commands are free to group by shader and primitive.
+/// The low 40 bits are left zero; the radix sort is stable, so submission order breaks ties.
+inline std::uint64_t makeSortKey(Layer layer, ShaderId shader, Primitive primitive) {
+    return (static_cast<std::uint64_t>(layer) << 56) |
+           (static_cast<std::uint64_t>(shader) << 48) |
+           (static_cast<std::uint64_t>(primitive) << 40);
+}
+
+/// @brief A compact draw request, executed later by a render backend
+struct RenderCommand {
+    std::uint64_t sortKey;
+    glm::vec2 center;
+    /// @brief Radius for circles, edge length for rects and triangles
+    float size;
+    glm::vec3 color;
+    Primitive primitive;
+    /// @brief Triangle-fan segment count for circles
+    std::uint8_t segments;
+};
+
+/// @brief Per-frame list of draw commands, sorted by key before execution
+/// @details Storage is reused between frames, so a steady-state frame does not allocate. A queue
+/// can also be built for a single tick on a FrameArena (see frame_arena.hpp).
+class RenderQueue {
+  public:
+    RenderQueue() = default;
+    explicit RenderQueue(std::pmr::memory_resource *resource)
+        : commands_(resource), scratch_(resource) {}
+
+    void clear() { commands_.clear(); }
+    /// @brief Make room for a number of commands, so an arena-backed queue never regrows
+    void reserve(std::size_t count) {
+        commands_.reserve(count);
+        scratch_.reserve(count);
+    }
+    const std::pmr::vector<RenderCommand> &commands() const { return commands_; }
+
+    void submit(Layer layer, Primitive primitive, glm::vec2 center, float size, glm::vec3 color,
+                int segments = 0) {
+        ShaderId shader =
+            primitive == Primitive::SdfCircle ? ShaderId::SdfCircle : ShaderId::FixedFunction;
+        commands_.push_back({makeSortKey(layer, shader, primitive), center, size, color, primitive,
+                             static_cast<std::uint8_t>(segments)});
+    }
+
+    // Counterparts of the immediate-mode helpers in utils.hpp
+    void drawCircle(glm::vec2 center, float radius, int numSegments, glm::vec3 color,
+                    Layer layer) {
+        submit(layer, Primitive::Circle, center, radius, color, numSegments);
+    }
+    void drawSdfCircle(glm::vec2 center, float radius, int fallbackSegments, glm::vec3 color,
+                       Layer layer) {
+        submit(layer, Primitive::SdfCircle, center, radius, color, fallbackSegments);
+    }
+    void drawRect(glm::vec2 center, float size, glm::vec3 color, Layer layer) {
+        submit(layer, Primitive::Rect, center, size, color);
+    }
+    void drawTriangle(glm::vec2 center, float size, glm::vec3 color, Layer layer) {
+        submit(layer, Primitive::Triangle, center, size, color);
+    }
+
+    /// @brief Stable LSD radix sort on the sort key, one byte per pass
+    /// @details Passes where every key has the same byte are skipped, so in practice only the
+    /// few bytes that actually vary are sorted.
+    void sort() {
+        scratch_.resize(commands_.size());
+        for (int shift = 0; shift < 64; shift += 8) {
+            std::array<std::size_t, 256> counts{};
+            for (const RenderCommand &command : commands_) {
+                counts[(command.sortKey >> shift) & 0xFF]++;
+            }
+            if (counts[(commands_.empty() ? 0 : commands_[0].sortKey >> shift) & 0xFF] ==
+                commands_.size()) {
+                continue;
+            }
+
+            std::size_t offset = 0;
+            for (std::size_t &count : counts) {
+                std::size_t bucketSize = count;
+                count = offset;
+                offset += bucketSize;
+            }
+            for (const RenderCommand &command : commands_) {
+                scratch_[counts[(command.sortKey >> shift) & 0xFF]++] = command;
+            }
+            commands_.swap(scratch_);
+        }
+    }
+
+  private:
+    std::pmr::vector<RenderCommand> commands_;
+    std::pmr::vector<RenderCommand> scratch_;
+};
@@ -0,0 +1,624 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "game.hpp"
+#include "udp_socket.hpp"
+
+// Spectator replication: the authoritative game sends state deltas to local clients over UDP.
+//
+// Bullet trajectories are analytic, so a bullet is sent once, as its quantized spawn parameters,
+// and clients move it themselves from then on. Clients also drop bullets that leave the field on
+// their own; only bullets removed inside the field need a despawn message. Every snapshot is a
+// delta from the newest tick the client acknowledged: the server keeps HISTORY_TICKS ticks of
+// despawns and the first bullet id spawned after each tick, and falls back to a full snapshot when
+// the client's baseline is older than that (or it just joined). Steady-state traffic therefore
+// depends on the spawn and removal rate, not on how many bullets are alive.
+//
+// Datagrams (little endian):
+//   client -> server  u8 HELLO | u8 ACK, u32 tick | u8 BYE
+//   server -> client  u8 SNAPSHOT, u32 tick, u32 baseline tick (FULL_SNAPSHOT for none),
+//                     u16 fragment index, u16 fragment count, payload fragment
+// The snapshot payload, reassembled from its fragments:
+//   i32 time, varint health, varint boss health, 3 x quantized position (player, boss, camera),
+//   varint enemy spawns, each: varint id delta, position, u16 angle, f32 speed, varint age
+//   varint player spawns, each: varint id delta, position, f32 speed, varint age
+//   varint despawns, each: varint id delta
+// Positions are two i16 scaled to [-1, 1]; varints are LEB128, signed ones zigzag encoded.
+
+namespace replication {
+constexpr std::uint16_t DEFAULT_PORT = 45451;
+constexpr std::uint8_t HELLO = 1;
+constexpr std::uint8_t ACK = 2;
+constexpr std::uint8_t BYE = 3;
+constexpr std::uint8_t SNAPSHOT = 16;
+constexpr std::uint32_t FULL_SNAPSHOT = 0xFFFFFFFFu;
+constexpr std::size_t SNAPSHOT_HEADER_SIZE = 1 + 4 + 4 + 2 + 2;
+/// @brief Payload bytes per datagram, so fragments fit the minimum IPv6 MTU
+constexpr std::size_t MAX_FRAGMENT_PAYLOAD = 1200;
+/// @brief Ticks of history a delta baseline can be
+constexpr int HISTORY_TICKS = 128;
+/// @brief Clients not heard from for this many ticks are dropped
+constexpr int CLIENT_TIMEOUT_TICKS = 5000 / TICK_MS;
+
+inline std::int16_t quantizePosition(float value) {
+    return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+inline float dequantizePosition(std::int16_t value) { return static_cast<float>(value) / 32767.0f; }
+
+inline std::uint16_t quantizeAngle(glm::vec2 direction) {
+    float turns = std::atan2(direction.y, direction.x) / 6.2831853f;
+    // A full turn wraps around to 0
+    return static_cast<std::uint16_t>(std::lround((turns < 0.0f ? turns + 1.0f : turns) * 65536));
+}
+inline glm::vec2 dequantizeAngle(std::uint16_t value) {
+    float angle = static_cast<float>(value) / 65536.0f * 6.2831853f;
+    return {std::cos(angle), std::sin(angle)};
+}
+} // namespace replication
+
+/// @brief Appends little-endian values to a byte vector
+class ByteWriter {
+  public:
+    explicit ByteWriter(std::vector<std::uint8_t> &bytes) : bytes_(bytes) {}
+
+    void u8(std::uint8_t value) { bytes_.push_back(value); }
+    void u16(std::uint16_t value) { integer(value); }
+    void u32(std::uint32_t value) { integer(value); }
+    void f32(float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        integer(bits);
+    }
+    void position(glm::vec2 value) {
+        integer(static_cast<std::uint16_t>(replication::quantizePosition(value.x)));
+        integer(static_cast<std::uint16_t>(replication::quantizePosition(value.y)));
+    }
+    void varint(std::uint64_t value) {
+        do {
+            auto byte = static_cast<std::uint8_t>(value & 0x7F);
+            value >>= 7;
+            bytes_.push_back(value != 0 ? byte | 0x80 : byte);
+        } while (value != 0);
+    }
+    void signedVarint(std::int64_t value) {
+        varint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+  private:
+    template <typename T> void integer(T value) {
+        for (std::size_t i = 0; i < sizeof(T); i++) {
+            bytes_.push_back(static_cast<std::uint8_t>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    std::vector<std::uint8_t> &bytes_;
+};
+
+/// @brief Reads what ByteWriter wrote; reading past the end returns zeros and clears ok()
+class ByteReader {
+  public:
+    ByteReader(const std::uint8_t *data, std::size_t size) : data_(data), size_(size) {}
+
+    std::uint8_t u8() { return integer<std::uint8_t>(); }
+    std::uint16_t u16() { return integer<std::uint16_t>(); }
+    std::uint32_t u32() { return integer<std::uint32_t>(); }
+    float f32() {
+        std::uint32_t bits = integer<std::uint32_t>();
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    glm::vec2 position() {
+        auto x = static_cast<std::int16_t>(integer<std::uint16_t>());
+        auto y = static_cast<std::int16_t>(integer<std::uint16_t>());
+        return {replication::dequantizePosition(x), replication::dequantizePosition(y)};
+    }
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint8_t byte = u8();
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                break;
+        }
+        return value;
+    }
+    std::int64_t signedVarint() {
+        std::uint64_t value = varint();
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    bool ok() const { return ok_; }
+
+  private:
+    template <typename T> T integer() {
+        if (position_ + sizeof(T) > size_) {
+            ok_ = false;
+            position_ = size_;
+            return 0;
+        }
+        T value = 0;
+        for (std::size_t i = 0; i < sizeof(T); i++) {
+            value |= static_cast<T>(static_cast<T>(data_[position_++]) << (8 * i));
+        }
+        return value;
+    }
+
+    const std::uint8_t *data_;
+    std::size_t size_;
+    std::size_t position_ = 0;
+    bool ok_ = true;
+};
+
+/// @brief Authoritative side: tracks bullet spawns and despawns and streams deltas to clients
+class ReplicationServer {
+  public:
+    /// @param sendInterval Send a snapshot every this many ticks
+    bool open(std::uint16_t port = replication::DEFAULT_PORT, int sendInterval = 2) {
+        sendInterval_ = std::max(1, sendInterval);
+        return socket_.open(port);
+    }
+    void close() { socket_.close(); }
+    bool enabled() const { return socket_.isOpen(); }
+    const std::string &error() const { return socket_.error(); }
+    std::size_t clientCount() const { return clients_.size(); }
+    /// @brief Bound address, useful after opening port 0
+    UdpAddress localAddress() const { return socket_.localAddress(); }
+
+    /// @brief Call once per simulated tick, in order
+    /// @param tick Number of ticks simulated so far
+    /// @param currentTime Simulation time the game was last updated to, in milliseconds
+    void publish(int tick, int currentTime, const GameState &gameState) {
+        TickEvents &tickEvents = events(tick);
+        tickEvents.tick = tick;
+        tickEvents.despawned.clear();
+        track(gameState.enemyBulletObjects, enemyMirror_, enemyIds_, currentTime, tickEvents);
+        track(gameState.playerBulletObjects, playerMirror_, playerIds_, currentTime, tickEvents);
+        tickEvents.nextIdAfter = nextId_;
+
+        receive(tick);
+        if (tick % sendInterval_ != 0)
+            return;
+        for (Client &client : clients_) {
+            sendSnapshot(client, tick, currentTime, gameState);
+        }
+    }
+
+    /// @brief Per-client traffic, in bytes per second of simulation time
+    void writeReport(std::ostream &out, int tick) {
+        for (Client &client : clients_) {
+            double windowSeconds = (tick - client.windowStartTick) * TICK_MS / 1000.0;
+            double sessionSeconds = (tick - client.joinTick) * TICK_MS / 1000.0;
+            out << "[replication] " << client.address.toString() << ": "
+                << (windowSeconds > 0.0 ? client.windowBytes / windowSeconds : 0.0)
+                << " B/s now, "
+                << (sessionSeconds > 0.0 ? client.bytesSent / sessionSeconds : 0.0)
+                << " B/s average, " << client.packetsSent << " packets, " << client.fullSnapshots
+                << " full snapshots\n";
+            client.windowBytes = 0;
+            client.windowStartTick = tick;
+        }
+        if (clients_.empty())
+            out << "[replication] no clients\n";
+    }
+
+    /// @brief Total bytes sent to every client so far
+    std::uint64_t bytesSent() const {
+        std::uint64_t total = 0;
+        for (const Client &client : clients_) {
+            total += client.bytesSent;
+        }
+        return total;
+    }
+
+  private:
+    struct Client {
+        UdpAddress address;
+        int ackedTick = -1;
+        int lastHeardTick = 0;
+        int joinTick = 0;
+        int windowStartTick = 0;
+        std::uint64_t bytesSent = 0;
+        std::uint64_t windowBytes = 0;
+        std::uint64_t packetsSent = 0;
+        std::uint64_t fullSnapshots = 0;
+    };
+    struct TickEvents {
+        int tick = -1;
+        /// @brief Bullets spawned after this tick have ids from here on
+        std::uint32_t nextIdAfter = 0;
+        /// @brief Bullets removed in this tick that clients cannot drop on their own
+        std::vector<std::uint32_t> despawned;
+    };
+
+    TickEvents &events(int tick) {
+        return history_[static_cast<std::size_t>(tick) % history_.size()];
+    }
+    const TickEvents &events(int tick) const {
+        return history_[static_cast<std::size_t>(tick) % history_.size()];
+    }
+
+    static bool sameSpawn(const EnemyBullet &a, const EnemyBullet &b) {
+        return a.initialTime == b.initialTime && a.speed == b.speed &&
+               a.initialPosition == b.initialPosition && a.initialDirection == b.initialDirection;
+    }
+    static bool sameSpawn(const PlayerBullet &a, const PlayerBullet &b) {
+        return a.initialTime == b.initialTime && a.speed == b.speed &&
+               a.initialPosition == b.initialPosition;
+    }
+
+    /// @brief Match the game's bullets with last tick's, assigning ids to new ones
+    /// @details Bullet vectors keep their order and only append, so one merge pass pairs them up.
+    template <typename Bullet>
+    void track(const std::vector<Bullet> &current, std::vector<Bullet> &mirror,
+               std::vector<std::uint32_t> &ids, int currentTime, TickEvents &events) {
+        scratchIds_.clear();
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < mirror.size(); i++) {
+            if (next < current.size() && sameSpawn(mirror[i], current[next])) {
+                scratchIds_.push_back(ids[i]);
+                next++;
+                continue;
+            }
+            // Clients remove bullets that flew out of the field themselves
+            Bullet removed = mirror[i];
+            if (!removed.update(currentTime, unusedState_))
+                events.despawned.push_back(ids[i]);
+        }
+        for (; next < current.size(); next++) {
+            scratchIds_.push_back(nextId_++);
+        }
+        mirror.assign(current.begin(), current.end());
+        ids.swap(scratchIds_);
+    }
+
+    void receive(int tick) {
+        std::uint8_t buffer[64];
+        UdpAddress from;
+        while (std::size_t size = socket_.receive(buffer, sizeof(buffer), from)) {
+            auto client = std::find_if(clients_.begin(), clients_.end(),
+                                       [&](const Client &c) { return c.address == from; });
+            if (buffer[0] == replication::HELLO && client == clients_.end()) {
+                Client joined;
+                joined.address = from;
+                joined.joinTick = joined.windowStartTick = joined.lastHeardTick = tick;
+                clients_.push_back(joined);
+                continue;
+            }
+            if (client == clients_.end())
+                continue;
+            client->lastHeardTick = tick;
+            if (buffer[0] == replication::BYE) {
+                clients_.erase(client);
+            } else if (buffer[0] == replication::ACK && size >= 5) {
+                ByteReader reader(buffer + 1, size - 1);
+                auto acked = static_cast<int>(reader.u32());
+                // Acks can arrive out of order; only move the baseline forward
+                if (acked <= tick)
+                    client->ackedTick = std::max(client->ackedTick, acked);
+            }
+        }
+        std::erase_if(clients_, [&](const Client &client) {
+            return tick - client.lastHeardTick > replication::CLIENT_TIMEOUT_TICKS;
+        });
+    }
+
+    /// @brief Whether the events of every tick after baseline up to tick are still kept
+    bool hasHistory(int baseline, int tick) const {
+        if (baseline < 0 || tick - baseline >= static_cast<int>(history_.size()))
+            return false;
+        for (int t = baseline; t <= tick; t++) {
+            if (events(t).tick != t)
+                return false;
+        }
+        return true;
+    }
+
+    void sendSnapshot(Client &client, int tick, int currentTime, const GameState &gameState) {
+        int baseline = hasHistory(client.ackedTick, tick) ? client.ackedTick : -1;
+        buildPayload(baseline, tick, currentTime, gameState);
+        client.fullSnapshots += baseline < 0 ? 1 : 0;
+
+        std::size_t fragments = std::max<std::size_t>(
+            1, (payload_.size() + replication::MAX_FRAGMENT_PAYLOAD - 1) /
+                   replication::MAX_FRAGMENT_PAYLOAD);
+        for (std::size_t index = 0; index < fragments; index++) {
+            std::size_t begin = index * replication::MAX_FRAGMENT_PAYLOAD;
+            std::size_t end = std::min(payload_.size(), begin + replication::MAX_FRAGMENT_PAYLOAD);
+            datagram_.clear();
+            ByteWriter writer(datagram_);
+            writer.u8(replication::SNAPSHOT);
+            writer.u32(static_cast<std::uint32_t>(tick));
+            writer.u32(baseline < 0 ? replication::FULL_SNAPSHOT
+                                    : static_cast<std::uint32_t>(baseline));
+            writer.u16(static_cast<std::uint16_t>(index));
+            writer.u16(static_cast<std::uint16_t>(fragments));
+            datagram_.insert(datagram_.end(), payload_.begin() + begin, payload_.begin() + end);
+            if (socket_.send(client.address, datagram_.data(), datagram_.size())) {
+                client.bytesSent += datagram_.size();
+                client.windowBytes += datagram_.size();
+                client.packetsSent++;
+            }
+        }
+    }
+
+    /// @param baseline Tick the client has, or -1 for a full snapshot
+    void buildPayload(int baseline, int tick, int currentTime, const GameState &gameState) {
+        payload_.clear();
+        ByteWriter writer(payload_);
+        writer.u32(static_cast<std::uint32_t>(currentTime));
+        writer.signedVarint(gameState.health);
+        writer.signedVarint(gameState.bossHealth);
+        writer.position(gameState.playerObject.currentPosition);
+        writer.position(gameState.bossObject.currentPosition);
+        writer.position(gameState.cameraOffset);
+
+        // The client has every live bullet spawned up to the baseline
+        std::uint32_t sinceId = baseline < 0 ? 0 : events(baseline).nextIdAfter;
+        writeSpawns(writer, enemyMirror_, enemyIds_, sinceId, currentTime);
+        writeSpawns(writer, playerMirror_, playerIds_, sinceId, currentTime);
+
+        scratchIds_.clear();
+        if (baseline >= 0) {
+            for (int t = baseline + 1; t <= tick; t++) {
+                // Bullets spawned after the baseline count too: the client may have them from an
+                // earlier delta of the same baseline. It ignores ids it does not know.
+                scratchIds_.insert(scratchIds_.end(), events(t).despawned.begin(),
+                                   events(t).despawned.end());
+            }
+            std::sort(scratchIds_.begin(), scratchIds_.end());
+        }
+        writer.varint(scratchIds_.size());
+        std::uint32_t previous = 0;
+        for (std::uint32_t id : scratchIds_) {
+            writer.varint(id - previous);
+            previous = id;
+        }
+    }
+
+    template <typename Bullet>
+    void writeSpawns(ByteWriter &writer, const std::vector<Bullet> &bullets,
+                     const std::vector<std::uint32_t> &ids, std::uint32_t sinceId,
+                     int currentTime) {
+        auto first = std::lower_bound(ids.begin(), ids.end(), sinceId) - ids.begin();
+        writer.varint(ids.size() - static_cast<std::size_t>(first));
+        std::uint32_t previous = 0;
+        for (auto i = static_cast<std::size_t>(first); i < ids.size(); i++) {
+            const Bullet &bullet = bullets[i];
+            writer.varint(ids[i] - previous);
+            previous = ids[i];
+            writer.position(bullet.initialPosition);
+            if constexpr (std::is_same_v<Bullet, EnemyBullet>)
+                writer.u16(replication::quantizeAngle(bullet.initialDirection));
+            writer.f32(bullet.speed);
+            writer.signedVarint(currentTime - bullet.initialTime);
+        }
+    }
+
+    UdpSocket socket_;
+    int sendInterval_ = 2;
+    std::vector<Client> clients_;
+    std::vector<EnemyBullet> enemyMirror_;
+    std::vector<PlayerBullet> playerMirror_;
+    std::vector<std::uint32_t> enemyIds_;
+    std::vector<std::uint32_t> playerIds_;
+    std::uint32_t nextId_ = 1;
+    std::array<TickEvents, replication::HISTORY_TICKS> history_;
+    std::vector<std::uint32_t> scratchIds_;
+    std::vector<std::uint8_t> payload_;
+    std::vector<std::uint8_t> datagram_;
+    /// @brief Bullet::update takes the game but bullets never touch it
+    GameState unusedState_{0, 0};
+};
+
+/// @brief Spectator side: rebuilds the game from the server's snapshots
+class ReplicationClient {
+  public:
+    /// @brief Open a local socket and announce this client to the server
+    bool connect(std::uint16_t serverPort = replication::DEFAULT_PORT) {
+        server_ = loopbackAddress(serverPort);
+        if (!socket_.open(0))
+            return false;
+        sendHello();
+        return true;
+    }
+    /// @brief Tell the server to stop sending
+    void disconnect() {
+        if (!socket_.isOpen())
+            return;
+        std::uint8_t bye = replication::BYE;
+        socket_.send(server_, &bye, 1);
+        socket_.close();
+    }
+    ~ReplicationClient() { disconnect(); }
+    const std::string &error() const { return socket_.error(); }
+
+    /// @brief Handle every pending datagram without waiting
+    /// @return true if at least one new tick was applied
+    bool poll() {
+        bool applied = false;
+        UdpAddress from;
+        while (std::size_t size = socket_.receive(buffer_.data(), buffer_.size(), from)) {
+            bytesReceived_ += size;
+            if (from == server_)
+                applied = handleDatagram(buffer_.data(), size) || applied;
+        }
+        // Keep saying hello until the server answers
+        auto now = std::chrono::steady_clock::now();
+        if (tick_ < 0 && now - lastHello_ > std::chrono::milliseconds(200))
+            sendHello();
+        return applied;
+    }
+
+    /// @brief The replicated game; only positions, health and bullets are filled in
+    const GameState &state() const { return state_; }
+    /// @brief Server tick of the state, or -1 before the first snapshot
+    int tick() const { return tick_; }
+    std::uint64_t bytesReceived() const { return bytesReceived_; }
+    std::uint64_t snapshotsApplied() const { return snapshotsApplied_; }
+    std::uint64_t fullSnapshots() const { return fullSnapshots_; }
+
+  private:
+    void sendHello() {
+        std::uint8_t hello = replication::HELLO;
+        socket_.send(server_, &hello, 1);
+        lastHello_ = std::chrono::steady_clock::now();
+    }
+
+    bool handleDatagram(const std::uint8_t *data, std::size_t size) {
+        if (size < replication::SNAPSHOT_HEADER_SIZE || data[0] != replication::SNAPSHOT)
+            return false;
+        ByteReader header(data + 1, replication::SNAPSHOT_HEADER_SIZE - 1);
+        auto tick = static_cast<int>(header.u32());
+        std::uint32_t baseline = header.u32();
+        std::uint16_t index = header.u16();
+        std::uint16_t count = header.u16();
+        if (tick <= tick_ || count == 0 || index >= count)
+            return false;
+
+        // A newer snapshot replaces one whose fragments are still incomplete
+        if (tick != assemblyTick_ || baseline != assemblyBaseline_) {
+            assemblyTick_ = tick;
+            assemblyBaseline_ = baseline;
+            fragments_.assign(count, {});
+            fragmentsMissing_ = count;
+        }
+        if (fragments_.size() != count || !fragments_[index].empty())
+            return false;
+        fragments_[index].assign(data + replication::SNAPSHOT_HEADER_SIZE, data + size);
+        if (--fragmentsMissing_ > 0)
+            return false;
+
+        payload_.clear();
+        for (const std::vector<std::uint8_t> &fragment : fragments_) {
+            payload_.insert(payload_.end(), fragment.begin(), fragment.end());
+        }
+        assemblyTick_ = -1;
+        return apply(tick, baseline);
+    }
+
+    bool apply(int tick, std::uint32_t baseline) {
+        bool full = baseline == replication::FULL_SNAPSHOT;
+        // A delta needs the baseline tick or newer; spawns and despawns it repeats are skipped
+        if (!full && (tick_ < 0 || static_cast<int>(baseline) > tick_))
+            return false;
+
+        ByteReader reader(payload_.data(), payload_.size());
+        auto time = static_cast<int>(reader.u32());
+        int health = static_cast<int>(reader.signedVarint());
+        int bossHealth = static_cast<int>(reader.signedVarint());
+        glm::vec2 player = reader.position();
+        glm::vec2 boss = reader.position();
+        glm::vec2 camera = reader.position();
+        if (full) {
+            state_.enemyBulletObjects.clear();
+            state_.playerBulletObjects.clear();
+            enemyIds_.clear();
+            playerIds_.clear();
+        }
+        readSpawns(reader, state_.enemyBulletObjects, enemyIds_, time);
+        readSpawns(reader, state_.playerBulletObjects, playerIds_, time);
+        std::uint64_t despawns = reader.varint();
+        std::uint32_t id = 0;
+        for (std::uint64_t i = 0; i < despawns && reader.ok(); i++) {
+            id += static_cast<std::uint32_t>(reader.varint());
+            remove(state_.enemyBulletObjects, enemyIds_, id);
+            remove(state_.playerBulletObjects, playerIds_, id);
+        }
+        if (!reader.ok())
+            return false;
+
+        state_.health = health;
+        state_.bossHealth = bossHealth;
+        state_.playerObject.currentPosition = player;
+        state_.bossObject.currentPosition = boss;
+        state_.cameraOffset = camera;
+        advance(state_.enemyBulletObjects, enemyIds_, time);
+        advance(state_.playerBulletObjects, playerIds_, time);
+        tick_ = tick;
+        snapshotsApplied_++;
+        fullSnapshots_ += full ? 1 : 0;
+
+        std::vector<std::uint8_t> ack;
+        ByteWriter writer(ack);
+        writer.u8(replication::ACK);
+        writer.u32(static_cast<std::uint32_t>(tick));
+        socket_.send(server_, ack.data(), ack.size());
+        return true;
+    }
+
+    template <typename Bullet>
+    void readSpawns(ByteReader &reader, std::vector<Bullet> &bullets,
+                    std::vector<std::uint32_t> &ids, int time) {
+        std::uint64_t count = reader.varint();
+        std::uint32_t id = 0;
+        for (std::uint64_t i = 0; i < count && reader.ok(); i++) {
+            id += static_cast<std::uint32_t>(reader.varint());
+            glm::vec2 position = reader.position();
+            glm::vec2 direction(1.0f, 0.0f);
+            if constexpr (std::is_same_v<Bullet, EnemyBullet>)
+                direction = replication::dequantizeAngle(reader.u16());
+            float speed = reader.f32();
+            auto spawnTime = static_cast<int>(time - reader.signedVarint());
+            // Already known from a newer baseline than the server assumed
+            if (!ids.empty() && id <= ids.back())
+                continue;
+            if constexpr (std::is_same_v<Bullet, EnemyBullet>)
+                bullets.emplace_back(direction, position, speed, spawnTime);
+            else
+                bullets.emplace_back(position, speed, spawnTime);
+            ids.push_back(id);
+        }
+    }
+
+    template <typename Bullet>
+    static void remove(std::vector<Bullet> &bullets, std::vector<std::uint32_t> &ids,
+                       std::uint32_t id) {
+        auto found = std::lower_bound(ids.begin(), ids.end(), id);
+        if (found == ids.end() || *found != id)
+            return;
+        bullets.erase(bullets.begin() + (found - ids.begin()));
+        ids.erase(found);
+    }
+
+    /// @brief Move every bullet to the given time, dropping those that left the field
+    template <typename Bullet>
+    void advance(std::vector<Bullet> &bullets, std::vector<std::uint32_t> &ids, int time) {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < bullets.size(); i++) {
+            if (bullets[i].update(time, state_))
+                continue;
+            bullets[kept] = bullets[i];
+            ids[kept] = ids[i];
+            kept++;
+        }
+        bullets.erase(bullets.begin() + static_cast<std::ptrdiff_t>(kept), bullets.end());
+        ids.resize(kept);
+    }
+
+    UdpSocket socket_;
+    UdpAddress server_;
+    std::array<std::uint8_t, 65536> buffer_{};
+    std::chrono::steady_clock::time_point lastHello_;
+    int assemblyTick_ = -1;
+    std::uint32_t assemblyBaseline_ = 0;
+    std::vector<std::vector<std::uint8_t>> fragments_;
+    std::size_t fragmentsMissing_ = 0;
+    std::vector<std::uint8_t> payload_;
+
+    GameState state_{0, 0};
+    std::vector<std::uint32_t> enemyIds_;
+    std::vector<std::uint32_t> playerIds_;
+    int tick_ = -1;
+    std::uint64_t bytesReceived_ = 0;
+    std::uint64_t snapshotsApplied_ = 0;
+    std::uint64_t fullSnapshots_ = 0;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/// @brief Tuning of ResolutionScaler
+struct ResolutionScalerConfig {
+    /// @brief Render cost per frame to stay under, in milliseconds
+    double budgetMilliseconds = 12.0;
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+    /// @brief Scales are multiples of this, so small cost changes do not cause new scales
+    float step = 0.05f;
+    /// @brief Frames averaged before deciding
+    int windowFrames = 20;
+    /// @brief Scale up only if the cost at the larger scale is predicted below this budget fraction
+    double upThreshold = 0.8;
+    /// @brief Frames after a change before the next decision
+    int cooldownFrames = 30;
+};
+
+/// @brief Picks the render scale from the measured cost of recent frames
+/// @details Cost is assumed proportional to the pixel count, i.e. the square of the scale. Over
+/// budget, the scale drops at once to where the average would fit. Under budget, it rises one step
+/// at a time, and only while the predicted cost at the larger scale stays below upThreshold of the
+/// budget. The gap between the two thresholds is the hysteresis that keeps the scale from
+/// oscillating between two steps. Measurements are discarded after every change, since they
+/// describe the old scale.
+class ResolutionScaler {
+  public:
+    /// @brief A scale change and the average cost that caused it
+    struct Decision {
+        long long frame = -1;
+        float from = 1.0f;
+        float to = 1.0f;
+        double averageMilliseconds = 0.0;
+    };
+
+    explicit ResolutionScaler(ResolutionScalerConfig config = {})
+        : config_(config), scale_(config.maxScale),
+          costs_(static_cast<std::size_t>(std::max(1, config.windowFrames))) {}
+
+    /// @brief Record the render cost of a frame drawn at the current scale
+    /// @return true if the scale changed
+    bool record(double costMilliseconds) {
+        frame_++;
+        costs_[costCount_++ % costs_.size()] = costMilliseconds;
+        if (costCount_ < costs_.size() || frame_ - lastDecision_.frame < config_.cooldownFrames)
+            return false;
+
+        double average = 0.0;
+        for (double cost : costs_) {
+            average += cost;
+        }
+        average /= static_cast<double>(costs_.size());
+
+        float target = scale_;
+        double budget = config_.budgetMilliseconds;
+        if (average > budget) {
+            // Round down to a step so the new scale fits; the epsilon absorbs float error
+            float fit = scale_ * static_cast<float>(std::sqrt(budget / average));
+            target = std::floor(fit / config_.step + 1e-3f) * config_.step;
+        } else {
+            float larger = std::round(scale_ / config_.step + 1.0f) * config_.step;
+            double predicted = average * (larger * larger) / (scale_ * scale_);
+            if (predicted < budget * config_.upThreshold)
+                target = larger;
+        }
+        target = std::clamp(target, config_.minScale, config_.maxScale);
+        if (std::abs(target - scale_) < config_.step / 2)
+            return false;
+
+        lastDecision_ = {frame_, scale_, target, average};
+        scale_ = target;
+        changes_++;
+        costCount_ = 0;
+        return true;
+    }
+
+    float scale() const { return scale_; }
+    int changes() const { return changes_; }
+    const Decision &lastDecision() const { return lastDecision_; }
+    const ResolutionScalerConfig &config() const { return config_; }
+
+  private:
+    ResolutionScalerConfig config_;
+    float scale_;
+    std::vector<double> costs_;
+    std::size_t costCount_ = 0;
+    long long frame_ = 0;
+    int changes_ = 0;
+    Decision lastDecision_;
+};
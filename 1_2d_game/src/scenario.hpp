@@ -0,0 +1,30 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <random>
+#include "game.hpp"
+
+/// @brief Fill a game with a reproducible field of bullets, for benchmarks and perf tests
+/// @details Enemy bullets drift slowly from uniformly random positions; player bullets fly up
+/// from random positions in the lower half. The same seed always produces the same state.
+/// @param currentTime Spawn time given to every bullet, in milliseconds
+inline void populateBulletField(GameState &gameState, int enemyBullets, int playerBullets,
+                                std::uint32_t seed, int currentTime = 0) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> unit(-0.9f, 0.9f);
+    std::uniform_real_distribution<float> lower(-0.9f, 0.0f);
+
+    gameState.enemyBulletObjects.reserve(gameState.enemyBulletObjects.size() + enemyBullets);
+    gameState.playerBulletObjects.reserve(gameState.playerBulletObjects.size() + playerBullets);
+    for (int i = 0; i < enemyBullets; i++) {
+        glm::vec2 position(unit(random), unit(random));
+        glm::vec2 direction(unit(random), unit(random));
+        if (glm::dot(direction, direction) < 1e-4f)
+            direction = glm::vec2(1.0f, 0.0f);
+        gameState.enemyBulletObjects.emplace_back(direction, position, 0.00002f, currentTime);
+    }
+    for (int i = 0; i < playerBullets; i++) {
+        gameState.playerBulletObjects.emplace_back(glm::vec2(unit(random), lower(random)), 0.001f,
+                                                   currentTime);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <GL/glew.h>
+#include <algorithm>
+#include <iostream>
+
+/// @brief Offscreen framebuffer the scene is drawn into at a fraction of the window resolution
+/// @details The color renderbuffer is allocated once at full size. A lower scale only draws into
+/// its bottom-left part, so changing the scale never reallocates; resolve() stretches that
+/// part over the destination with linear filtering. The scene is drawn without a depth test, so
+/// there is no depth attachment.
+class SceneTarget {
+  public:
+    /// @return false if framebuffer objects are unsupported or the framebuffer is incomplete; the
+    /// target then stays disabled
+    bool init(int width, int height) {
+        if (!GLEW_VERSION_3_0 && !GLEW_ARB_framebuffer_object)
+            return false;
+
+        width_ = width;
+        height_ = height;
+
+        glGenFramebuffers(1, &framebuffer_);
+        glGenRenderbuffers(1, &renderbuffer_);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer_);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                                  renderbuffer_);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Scene framebuffer incomplete: 0x" << std::hex << status << std::dec
+                      << '\n';
+            glDeleteFramebuffers(1, &framebuffer_);
+            glDeleteRenderbuffers(1, &renderbuffer_);
+            framebuffer_ = 0;
+            renderbuffer_ = 0;
+            return false;
+        }
+        return true;
+    }
+
+    bool enabled() const { return framebuffer_ != 0; }
+
+    /// @brief Redirect rendering into the scaled part of the scene framebuffer
+    void begin(float scale) {
+        scaledWidth_ = std::clamp(static_cast<int>(width_ * scale + 0.5f), 1, width_);
+        scaledHeight_ = std::clamp(static_cast<int>(height_ * scale + 0.5f), 1, height_);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+        glViewport(0, 0, scaledWidth_, scaledHeight_);
+    }
+
+    /// @brief Upscale the scene onto a framebuffer of full size and leave that one bound
+    /// @param destination 0 for the window, or another framebuffer such as the capture target
+    void resolve(GLuint destination) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer_);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, destination);
+        glBlitFramebuffer(0, 0, scaledWidth_, scaledHeight_, 0, 0, width_, height_,
+                          GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glBindFramebuffer(GL_FRAMEBUFFER, destination);
+        glViewport(0, 0, width_, height_);
+    }
+
+    int scaledWidth() const { return scaledWidth_; }
+    int scaledHeight() const { return scaledHeight_; }
+
+  private:
+    int width_ = 0;
+    int height_ = 0;
+    int scaledWidth_ = 0;
+    int scaledHeight_ = 0;
+    GLuint framebuffer_ = 0;
+    GLuint renderbuffer_ = 0;
+};
@@ -0,0 +1,177 @@
+#pragma once
+#include <GL/glew.h>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include "program_cache.hpp"
+
+/// @brief Compile a single shader stage
+/// @param type GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
+/// @param source GLSL source code
+/// @return The shader handle, or 0 if compilation failed
+inline GLuint compileShader(GLenum type, const char *source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint status = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+        GLint length = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        std::string log(static_cast<size_t>(length > 0 ? length : 1), '\0');
+        glGetShaderInfoLog(shader, length, nullptr, log.data());
+        std::cerr << "Shader compile failed: " << log << '\n';
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+/// @brief Whether linked programs can be saved with glGetProgramBinary and loaded again
+inline bool programBinariesSupported() {
+    if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+        return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+/// @brief Compile and link a vertex/fragment shader program
+/// @param vertexSource GLSL source of the vertex shader
+/// @param fragmentSource GLSL source of the fragment shader
+/// @param retrievable Ask the driver to keep the binary for glGetProgramBinary
+/// @return The program handle, or 0 if shaders are unsupported or building failed
+inline GLuint createProgram(const char *vertexSource, const char *fragmentSource,
+                            bool retrievable = false) {
+    if (!GLEW_VERSION_2_0)
+        return 0;
+
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+    if (vertexShader == 0 || fragmentShader == 0) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    if (retrievable)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+        std::string log(static_cast<size_t>(length > 0 ? length : 1), '\0');
+        glGetProgramInfoLog(program, length, nullptr, log.data());
+        std::cerr << "Program link failed: " << log << '\n';
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+/// @brief Builds each shader program once and keeps linked binaries in an on-disk cache
+/// @details A program is loaded with glProgramBinary when the cache holds a binary for the same
+/// sources and driver. Otherwise, or if the driver rejects the binary, it is compiled and linked
+/// from source and the new binary replaces the cached one.
+class ShaderManager {
+  public:
+    /// @param directory Where binaries are cached; empty disables the cache
+    void setCacheDirectory(std::string directory) { directory_ = std::move(directory); }
+
+    /// @brief Get a program, building it on the first request for its name
+    /// @return The program handle, or 0 if shaders are unsupported or building failed
+    GLuint program(const std::string &name, const char *vertexSource, const char *fragmentSource) {
+        auto found = programs_.find(name);
+        if (found != programs_.end())
+            return found->second;
+
+        auto start = std::chrono::steady_clock::now();
+        bool cached = !directory_.empty() && programBinariesSupported();
+        std::string path = directory_ + "/" + name + ".bin";
+        std::uint64_t key = 0;
+        GLuint program = 0;
+        if (cached) {
+            key = programCacheKey({vertexSource, fragmentSource, glString(GL_VENDOR),
+                                   glString(GL_RENDERER), glString(GL_VERSION)});
+            program = loadBinary(path, key);
+        }
+        if (program != 0) {
+            cacheHits_++;
+        } else {
+            program = createProgram(vertexSource, fragmentSource, cached);
+            compiled_++;
+            if (program != 0 && cached)
+                saveBinary(program, path, key);
+        }
+        milliseconds_ +=
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                .count();
+        programs_.emplace(name, program);
+        return program;
+    }
+
+    /// @brief Programs loaded from the cache
+    int cacheHits() const { return cacheHits_; }
+    /// @brief Programs compiled and linked from source
+    int compiled() const { return compiled_; }
+    /// @brief Total time spent building programs
+    double milliseconds() const { return milliseconds_; }
+
+  private:
+    static const char *glString(GLenum name) {
+        const GLubyte *value = glGetString(name);
+        return value != nullptr ? reinterpret_cast<const char *>(value) : "";
+    }
+
+    static GLuint loadBinary(const std::string &path, std::uint64_t key) {
+        ProgramBinary binary;
+        if (!readProgramBinary(path, key, binary))
+            return 0;
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, binary.format, binary.data.data(),
+                        static_cast<GLsizei>(binary.data.size()));
+        // The key cannot capture everything, so the driver may still reject the binary
+        GLint status = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status != GL_TRUE) {
+            glDeleteProgram(program);
+            return 0;
+        }
+        return program;
+    }
+
+    static void saveBinary(GLuint program, const std::string &path, std::uint64_t key) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+        ProgramBinary binary;
+        binary.data.resize(static_cast<std::size_t>(length));
+        GLenum format = 0;
+        glGetProgramBinary(program, length, nullptr, &format, binary.data.data());
+        binary.format = format;
+
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+        if (!writeProgramBinary(path, key, binary))
+            std::cerr << "Failed to cache the program binary in " << path << '\n';
+    }
+
+    std::string directory_;
+    std::map<std::string, GLuint> programs_;
+    int cacheHits_ = 0;
+    int compiled_ = 0;
+    double milliseconds_ = 0.0;
+};
@@ -0,0 +1,296 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHARED_STATE_SUPPORTED 1
+#else
+#define SHARED_STATE_SUPPORTED 0
+#endif
+
+// Layout of the per-tick game state published in POSIX shared memory, and the reader side.
+//
+// The region starts with a SharedStateHeader followed by slotCount slots. A slot is a
+// SharedFrameHeader, then maxBullets enemy bullets, then maxBullets player bullets. Tick t goes
+// into slot t % slotCount. Every slot is guarded by a seqlock: the writer makes the sequence odd,
+// writes the slot, then makes it even again. A reader copies the slot and accepts the copy only if
+// the sequence was even and unchanged around the copy, so the writer never waits for readers.
+//
+// This header has no dependency on the game so external tools can include it on its own.
+
+namespace shared_state {
+constexpr char MAGIC[8] = {'B', 'H', 'S', 'T', 'A', 'T', 'E', '\0'};
+constexpr std::uint32_t VERSION = 1;
+/// @brief Name used when none is given; POSIX shared memory names start with a slash
+constexpr const char *DEFAULT_NAME = "/cs451_game_state";
+} // namespace shared_state
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+struct SharedStateHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t slotCount;
+    std::uint32_t maxBullets;
+    /// @brief Bytes from one slot to the next
+    std::uint32_t slotSize;
+    /// @brief Tick of the newest complete slot plus one; 0 until the first publish
+    std::atomic<std::uint64_t> published;
+};
+
+struct SharedBullet {
+    float x;
+    float y;
+};
+
+struct alignas(64) SharedFrameHeader {
+    /// @brief Seqlock sequence: odd while the slot is being written
+    std::atomic<std::uint32_t> sequence;
+    std::int32_t tick;
+    std::int32_t health;
+    std::int32_t bossHealth;
+    float playerX;
+    float playerY;
+    float bossX;
+    float bossY;
+    float cameraX;
+    float cameraY;
+    /// @brief Bullets stored in the slot, at most maxBullets each
+    std::uint32_t enemyBulletCount;
+    std::uint32_t playerBulletCount;
+    /// @brief Bullets the game had but the slot could not hold
+    std::uint32_t droppedBullets;
+};
+
+/// @brief Bytes before the first slot: the region header, padded to a cache line
+constexpr std::size_t sharedHeaderSize() { return (sizeof(SharedStateHeader) + 63) / 64 * 64; }
+
+/// @brief Bytes of one slot for the given bullet capacity, padded to a cache line
+constexpr std::size_t sharedSlotSize(std::uint32_t maxBullets) {
+    std::size_t bullets = 2 * std::size_t{maxBullets} * sizeof(SharedBullet);
+    return (sizeof(SharedFrameHeader) + bullets + 63) / 64 * 64;
+}
+
+/// @brief Bytes of the whole region
+constexpr std::size_t sharedRegionSize(std::uint32_t slotCount, std::uint32_t maxBullets) {
+    return sharedHeaderSize() + slotCount * sharedSlotSize(maxBullets);
+}
+
+/// @brief A consistent copy of one published tick
+struct SharedFrame {
+    std::int32_t tick = -1;
+    std::int32_t health = 0;
+    std::int32_t bossHealth = 0;
+    float playerX = 0.0f;
+    float playerY = 0.0f;
+    float bossX = 0.0f;
+    float bossY = 0.0f;
+    float cameraX = 0.0f;
+    float cameraY = 0.0f;
+    std::uint32_t droppedBullets = 0;
+    std::vector<SharedBullet> enemyBullets;
+    std::vector<SharedBullet> playerBullets;
+};
+
+/// @brief A shared memory object mapped into this process
+class SharedMapping {
+  public:
+    SharedMapping() = default;
+    ~SharedMapping() { unmap(); }
+    SharedMapping(const SharedMapping &) = delete;
+    SharedMapping &operator=(const SharedMapping &) = delete;
+
+    /// @brief Create (or replace) the object with the given size and map it read-write
+    bool create(const std::string &name, std::size_t size) {
+#if SHARED_STATE_SUPPORTED
+        unmap();
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0)
+            return fail("shm_open failed for " + name);
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            shm_unlink(name.c_str());
+            return fail("ftruncate failed for " + name);
+        }
+        bool mapped = map(fd, size, PROT_READ | PROT_WRITE);
+        ::close(fd);
+        if (!mapped) {
+            shm_unlink(name.c_str());
+            return false;
+        }
+        name_ = name;
+        owner_ = true;
+        return true;
+#else
+        (void)name;
+        (void)size;
+        return fail("shared memory export needs a POSIX system");
+#endif
+    }
+
+    /// @brief Map an existing object read-only
+    bool attach(const std::string &name) {
+#if SHARED_STATE_SUPPORTED
+        unmap();
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return fail("no shared state named " + name + " (is the game running with --export?)");
+        struct stat info {};
+        bool mapped = fstat(fd, &info) == 0 &&
+                      map(fd, static_cast<std::size_t>(info.st_size), PROT_READ);
+        ::close(fd);
+        return mapped;
+#else
+        (void)name;
+        return fail("shared memory export needs a POSIX system");
+#endif
+    }
+
+    /// @brief Unmap, and remove the object if this process created it
+    void unmap() {
+#if SHARED_STATE_SUPPORTED
+        if (data_ != nullptr)
+            munmap(data_, size_);
+        if (owner_)
+            shm_unlink(name_.c_str());
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        owner_ = false;
+        name_.clear();
+    }
+
+    unsigned char *data() const { return static_cast<unsigned char *>(data_); }
+    std::size_t size() const { return size_; }
+    const std::string &error() const { return error_; }
+
+  private:
+#if SHARED_STATE_SUPPORTED
+    bool map(int fd, std::size_t size, int protection) {
+        if (size == 0)
+            return fail("shared state is empty");
+        void *data = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+            return fail("mmap failed");
+        data_ = data;
+        size_ = size;
+        return true;
+    }
+#endif
+    bool fail(std::string message) {
+        error_ = std::move(message);
+        return false;
+    }
+
+    void *data_ = nullptr;
+    std::size_t size_ = 0;
+    bool owner_ = false;
+    std::string name_;
+    std::string error_;
+};
+
+/// @brief Reads ticks published by a running game without ever blocking it
+class StateReader {
+  public:
+    /// @return false if the game is not exporting or the layout does not match; see error()
+    bool attach(const std::string &name = shared_state::DEFAULT_NAME) {
+        if (!mapping_.attach(name))
+            return false;
+        if (mapping_.size() < sizeof(SharedStateHeader)) {
+            mapping_.unmap();
+            return fail("shared state is truncated");
+        }
+        const SharedStateHeader &header = this->header();
+        if (std::memcmp(header.magic, shared_state::MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != shared_state::VERSION || header.slotCount == 0 ||
+            header.slotSize != sharedSlotSize(header.maxBullets) ||
+            mapping_.size() < sharedRegionSize(header.slotCount, header.maxBullets)) {
+            mapping_.unmap();
+            return fail("shared state has an unknown layout or version");
+        }
+        return true;
+    }
+    void detach() { mapping_.unmap(); }
+    bool attached() const { return mapping_.data() != nullptr; }
+
+    /// @brief Newest published tick, or -1 if nothing was published yet
+    long long latestTick() const {
+        return static_cast<long long>(header().published.load(std::memory_order_acquire)) - 1;
+    }
+
+    /// @brief Copy the newest published tick
+    /// @return false if nothing was published yet or the writer kept overwriting the slot
+    bool readLatest(SharedFrame &frame) const {
+        long long tick = latestTick();
+        return tick >= 0 && read(tick, frame);
+    }
+
+    /// @brief Copy a specific tick, if it is still in the ring
+    /// @return false if the tick was overwritten already, not published yet, or kept changing
+    bool read(long long tick, SharedFrame &frame) const {
+        const SharedStateHeader &header = this->header();
+        if (tick < 0)
+            return false;
+        const unsigned char *slot = mapping_.data() + sharedHeaderSize() +
+                                    static_cast<std::size_t>(tick % header.slotCount) *
+                                        header.slotSize;
+        const auto *frameHeader = reinterpret_cast<const SharedFrameHeader *>(slot);
+        const auto *bullets =
+            reinterpret_cast<const SharedBullet *>(slot + sizeof(SharedFrameHeader));
+
+        constexpr int ATTEMPTS = 16;
+        for (int attempt = 0; attempt < ATTEMPTS; attempt++) {
+            std::uint32_t before = frameHeader->sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+                continue;
+            if (frameHeader->tick != tick)
+                return false;
+            frame.tick = frameHeader->tick;
+            frame.health = frameHeader->health;
+            frame.bossHealth = frameHeader->bossHealth;
+            frame.playerX = frameHeader->playerX;
+            frame.playerY = frameHeader->playerY;
+            frame.bossX = frameHeader->bossX;
+            frame.bossY = frameHeader->bossY;
+            frame.cameraX = frameHeader->cameraX;
+            frame.cameraY = frameHeader->cameraY;
+            frame.droppedBullets = frameHeader->droppedBullets;
+            std::uint32_t enemyCount = std::min(frameHeader->enemyBulletCount, header.maxBullets);
+            std::uint32_t playerCount = std::min(frameHeader->playerBulletCount, header.maxBullets);
+            frame.enemyBullets.assign(bullets, bullets + enemyCount);
+            frame.playerBullets.assign(bullets + header.maxBullets,
+                                       bullets + header.maxBullets + playerCount);
+            // The copy is only valid if no write started while it was taken
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (frameHeader->sequence.load(std::memory_order_relaxed) == before)
+                return true;
+        }
+        return false;
+    }
+
+    std::uint32_t slotCount() const { return header().slotCount; }
+    const std::string &error() const { return error_.empty() ? mapping_.error() : error_; }
+
+  private:
+    const SharedStateHeader &header() const {
+        return *reinterpret_cast<const SharedStateHeader *>(mapping_.data());
+    }
+    bool fail(std::string message) {
+        error_ = std::move(message);
+        return false;
+    }
+
+    SharedMapping mapping_;
+    std::string error_;
+};
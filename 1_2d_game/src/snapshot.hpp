@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "game.hpp"
+
+// Copying a GameState is a handful of scalars plus the two bullet vectors. The bullets are
+// trivially copyable, so once the destination has enough capacity each vector copies as a single
+// memmove without allocating.
+static_assert(std::is_trivially_copyable_v<EnemyBullet>);
+static_assert(std::is_trivially_copyable_v<PlayerBullet>);
+
+/// @brief Game states of the last N ticks, kept for rollback, rewind and desync bisection
+/// @details Slots are reused in a ring indexed by tick, so saving and restoring do not allocate
+/// after the bullet vectors reached their peak size.
+class SnapshotRing {
+  public:
+    /// @param capacity Number of ticks kept
+    /// @param reserveBullets Bullets of each kind to preallocate per slot
+    explicit SnapshotRing(std::size_t capacity, std::size_t reserveBullets = 0)
+        : slots_(capacity > 0 ? capacity : 1) {
+        for (Slot &slot : slots_) {
+            slot.state.enemyBulletObjects.reserve(reserveBullets);
+            slot.state.playerBulletObjects.reserve(reserveBullets);
+        }
+    }
+
+    /// @brief Store the state after the given number of ticks, replacing the oldest snapshot
+    void save(int tick, const GameState &gameState) {
+        Slot &slot = slotOf(tick);
+        slot.tick = tick;
+        slot.state = gameState;
+        newestTick_ = tick > newestTick_ ? tick : newestTick_;
+    }
+
+    /// @brief Overwrite the game with the snapshot of a tick
+    /// @return false if that tick is not in the ring (too old, or never saved)
+    bool restore(int tick, GameState &gameState) const {
+        if (!contains(tick))
+            return false;
+        gameState = slots_[static_cast<std::size_t>(tick) % slots_.size()].state;
+        return true;
+    }
+
+    bool contains(int tick) const {
+        return tick >= 0 && slots_[static_cast<std::size_t>(tick) % slots_.size()].tick == tick;
+    }
+    std::size_t capacity() const { return slots_.size(); }
+    /// @brief Latest tick saved so far, or -1
+    int newestTick() const { return newestTick_; }
+
+    /// @brief Drop snapshots newer than a tick, after rolling back to it
+    void discardAfter(int tick) {
+        for (Slot &slot : slots_) {
+            if (slot.tick > tick)
+                slot.tick = -1;
+        }
+        newestTick_ = tick < newestTick_ ? tick : newestTick_;
+    }
+
+  private:
+    struct Slot {
+        int tick = -1;
+        GameState state{0, 0};
+    };
+
+    Slot &slotOf(int tick) { return slots_[static_cast<std::size_t>(tick) % slots_.size()]; }
+
+    std::vector<Slot> slots_;
+    int newestTick_ = -1;
+};
@@ -0,0 +1,234 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "image_io.hpp"
+#include "profiler.hpp"
+#include "render_queue.hpp"
+#include "thread_pool.hpp"
+
+/// @brief Tile-binned, multi-threaded software rasterizer writing to an RGBA framebuffer
+/// @details Offers the same draw calls as utils.hpp so it can stand in for GL where no context
+/// exists (build machines, golden-image tests, headless replays). Draw calls only record shapes;
+/// flush() bins them into tiles and rasterizes the tiles in parallel. Each tile is rasterized as
+/// horizontal spans, so inner loops are plain fills that the compiler vectorizes. Shapes are
+/// drawn in submission order with hard edges and no depth test.
+class SoftRasterizer {
+  public:
+    static constexpr int TILE_SIZE = 64;
+
+    /// @param threadCount Rasterizer threads including the caller; 0 picks the core count
+    SoftRasterizer(int width, int height, unsigned threadCount = 0)
+        : width_(width), height_(height), tilesX_((width + TILE_SIZE - 1) / TILE_SIZE),
+          tilesY_((height + TILE_SIZE - 1) / TILE_SIZE),
+          pixels_(static_cast<std::size_t>(width) * height),
+          bins_(static_cast<std::size_t>(tilesX_) * tilesY_), pool_(threadCount) {}
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    /// @brief Framebuffer contents as packed RGBA (see packRgba), top row first
+    const std::vector<std::uint32_t> &pixels() const { return pixels_; }
+    std::uint32_t pixel(int x, int y) const {
+        return pixels_[static_cast<std::size_t>(y) * width_ + x];
+    }
+    unsigned threadCount() const { return pool_.threadCount(); }
+
+    /// @brief Set the world-to-clip transform used by following draw calls
+    void setViewProjection(const glm::mat4 &viewProjection) { viewProjection_ = viewProjection; }
+    /// @brief Set the color every tile is cleared to at the start of the next flush
+    void clear(glm::fvec3 color) { clearColor_ = toRgba(color); }
+
+    /// @brief Draw a filled circle; numSegments is accepted for API parity and ignored
+    void drawCircle(glm::fvec2 center, float radius, int /*numSegments*/, glm::fvec3 color) {
+        glm::vec2 scale = pixelScale();
+        Shape shape{
+            Shape::Kind::Circle, {toPixel(center), radius * scale, {}}, toRgba(color), 0, 0};
+        addShape(shape, shape.v[0] - shape.v[1], shape.v[0] + shape.v[1]);
+    }
+    void drawRect(glm::fvec2 center, float size, glm::fvec3 color) {
+        float half = size / 2.0f;
+        glm::vec2 a = toPixel(center + glm::vec2(-half, -half));
+        glm::vec2 b = toPixel(center + glm::vec2(half, half));
+        Shape shape{
+            Shape::Kind::Rect, {glm::min(a, b), glm::max(a, b), {}}, toRgba(color), 0, 0};
+        addShape(shape, shape.v[0], shape.v[1]);
+    }
+    void drawTriangle(glm::fvec2 center, float size, glm::fvec3 color) {
+        Shape shape{Shape::Kind::Triangle,
+                    {toPixel(center + glm::vec2(0.0f, size / 2)),
+                     toPixel(center + glm::vec2(-size / 2, -size / 2)),
+                     toPixel(center + glm::vec2(size / 2, -size / 2))},
+                    toRgba(color),
+                    0,
+                    0};
+        addShape(shape, glm::min(glm::min(shape.v[0], shape.v[1]), shape.v[2]),
+                 glm::max(glm::max(shape.v[0], shape.v[1]), shape.v[2]));
+    }
+
+    /// @brief Rasterize every shape recorded since the last flush into the framebuffer
+    void flush() {
+        PROFILE_ZONE("SoftRasterizer::flush");
+        pool_.parallelFor(bins_.size(), [this](std::size_t tile) { rasterizeTile(tile); });
+        shapes_.clear();
+        for (std::vector<std::uint32_t> &bin : bins_) {
+            bin.clear();
+        }
+    }
+
+    bool writePpm(const std::string &path) const {
+        return ::writePpm(path, width_, height_, pixels_.data());
+    }
+
+  private:
+    struct Shape {
+        enum class Kind : std::uint8_t { Circle, Rect, Triangle };
+        Kind kind;
+        /// @brief Circle: center, radii. Rect: min, max. Triangle: vertices. All in pixels.
+        glm::vec2 v[3];
+        std::uint32_t color;
+        /// @brief Rows [rowBegin, rowEnd) the shape can cover, filled in when binned
+        int rowBegin;
+        int rowEnd;
+    };
+
+    static std::uint32_t toRgba(glm::fvec3 color) {
+        glm::vec3 scaled = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+        return packRgba(static_cast<std::uint8_t>(scaled.x), static_cast<std::uint8_t>(scaled.y),
+                        static_cast<std::uint8_t>(scaled.z));
+    }
+    glm::vec2 toPixel(glm::vec2 world) const {
+        glm::vec4 clip = viewProjection_ * glm::vec4(world, 0.0f, 1.0f);
+        return {(clip.x * 0.5f + 0.5f) * static_cast<float>(width_),
+                (0.5f - clip.y * 0.5f) * static_cast<float>(height_)};
+    }
+    glm::vec2 pixelScale() const {
+        return {std::abs(viewProjection_[0][0]) * static_cast<float>(width_) / 2.0f,
+                std::abs(viewProjection_[1][1]) * static_cast<float>(height_) / 2.0f};
+    }
+
+    void addShape(Shape shape, glm::vec2 min, glm::vec2 max) {
+        if (max.x < 0.0f || max.y < 0.0f || min.x >= static_cast<float>(width_) ||
+            min.y >= static_cast<float>(height_))
+            return;
+        int tx0 = std::max(0, static_cast<int>(min.x) / TILE_SIZE);
+        int ty0 = std::max(0, static_cast<int>(min.y) / TILE_SIZE);
+        int tx1 = std::min(tilesX_ - 1, static_cast<int>(max.x) / TILE_SIZE);
+        int ty1 = std::min(tilesY_ - 1, static_cast<int>(max.y) / TILE_SIZE);
+
+        shape.rowBegin = std::max(0, static_cast<int>(std::floor(min.y)));
+        shape.rowEnd = std::min(height_, static_cast<int>(std::ceil(max.y)) + 1);
+
+        auto index = static_cast<std::uint32_t>(shapes_.size());
+        shapes_.push_back(shape);
+        for (int ty = ty0; ty <= ty1; ty++) {
+            for (int tx = tx0; tx <= tx1; tx++) {
+                bins_[static_cast<std::size_t>(ty) * tilesX_ + tx].push_back(index);
+            }
+        }
+    }
+
+    void rasterizeTile(std::size_t tile) {
+        PROFILE_ZONE("rasterizeTile");
+        int x0 = static_cast<int>(tile % tilesX_) * TILE_SIZE;
+        int y0 = static_cast<int>(tile / tilesX_) * TILE_SIZE;
+        int x1 = std::min(x0 + TILE_SIZE, width_);
+        int y1 = std::min(y0 + TILE_SIZE, height_);
+
+        for (int y = y0; y < y1; y++) {
+            fillSpan(y, x0, x1, clearColor_);
+        }
+        for (std::uint32_t index : bins_[tile]) {
+            const Shape &shape = shapes_[index];
+            int rowBegin = std::max(y0, shape.rowBegin);
+            int rowEnd = std::min(y1, shape.rowEnd);
+            for (int y = rowBegin; y < rowEnd; y++) {
+                auto [begin, end] = spanOf(shape, static_cast<float>(y) + 0.5f);
+                fillSpan(y, std::max(begin, x0), std::min(end, x1), shape.color);
+            }
+        }
+    }
+
+    /// @brief Pixels [begin, end) of the row whose centers lie inside the shape
+    static std::pair<int, int> spanOf(const Shape &shape, float rowCenter) {
+        float left = 0.0f;
+        float right = 0.0f;
+        switch (shape.kind) {
+        case Shape::Kind::Circle: {
+            float dy = (rowCenter - shape.v[0].y) / shape.v[1].y;
+            float t = 1.0f - dy * dy;
+            if (t < 0.0f)
+                return {0, 0};
+            float half = shape.v[1].x * std::sqrt(t);
+            left = shape.v[0].x - half;
+            right = shape.v[0].x + half;
+            break;
+        }
+        case Shape::Kind::Rect:
+            if (rowCenter < shape.v[0].y || rowCenter >= shape.v[1].y)
+                return {0, 0};
+            left = shape.v[0].x;
+            right = shape.v[1].x;
+            break;
+        case Shape::Kind::Triangle: {
+            int crossings = 0;
+            for (int i = 0; i < 3; i++) {
+                glm::vec2 a = shape.v[i];
+                glm::vec2 b = shape.v[(i + 1) % 3];
+                if ((a.y <= rowCenter) == (b.y <= rowCenter))
+                    continue;
+                float x = a.x + (rowCenter - a.y) / (b.y - a.y) * (b.x - a.x);
+                left = crossings == 0 ? x : std::min(left, x);
+                right = crossings == 0 ? x : std::max(right, x);
+                crossings++;
+            }
+            if (crossings < 2)
+                return {0, 0};
+            break;
+        }
+        }
+        return {static_cast<int>(std::ceil(left - 0.5f)),
+                static_cast<int>(std::ceil(right - 0.5f))};
+    }
+
+    void fillSpan(int y, int begin, int end, std::uint32_t color) {
+        if (begin >= end)
+            return;
+        std::uint32_t *row = pixels_.data() + static_cast<std::size_t>(y) * width_;
+        std::fill(row + begin, row + end, color);
+    }
+
+    int width_;
+    int height_;
+    int tilesX_;
+    int tilesY_;
+    std::vector<std::uint32_t> pixels_;
+    std::vector<Shape> shapes_;
+    /// @brief Per tile, indices into shapes_ in submission order
+    std::vector<std::vector<std::uint32_t>> bins_;
+    glm::mat4 viewProjection_{1.0f};
+    std::uint32_t clearColor_ = packRgba(0, 0, 0);
+    ThreadPool pool_;
+};
+
+/// @brief Draw every command of a queue with the software rasterizer
+/// @details SDF circles have no software shading path and are drawn as plain circles.
+inline void executeRenderQueue(const RenderQueue &queue, SoftRasterizer &rasterizer) {
+    for (const RenderCommand &command : queue.commands()) {
+        switch (command.primitive) {
+        case Primitive::SdfCircle:
+        case Primitive::Circle:
+            rasterizer.drawCircle(command.center, command.size, command.segments, command.color);
+            break;
+        case Primitive::Rect:
+            rasterizer.drawRect(command.center, command.size, command.color);
+            break;
+        case Primitive::Triangle:
+            rasterizer.drawTriangle(command.center, command.size, command.color);
+            break;
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+#include "game.hpp"
+#include "shared_state.hpp"
+
+/// @brief Publishes the state of every tick into shared memory for external tools
+/// @details See shared_state.hpp for the layout and StateReader for the other side. Publishing
+/// copies the positions into the next ring slot under its seqlock and never waits for readers.
+class StateExporter {
+  public:
+    /// @brief Create the shared memory object, replacing a stale one of the same name
+    /// @param slotCount Ticks kept, so slow readers can still pick up recent ones
+    /// @param maxBullets Bullets of each kind stored per tick; extra bullets are counted as dropped
+    bool open(const std::string &name = shared_state::DEFAULT_NAME, std::uint32_t slotCount = 8,
+              std::uint32_t maxBullets = 16384) {
+        slotCount = std::max(1u, slotCount);
+        if (!mapping_.create(name, sharedRegionSize(slotCount, maxBullets)))
+            return false;
+        auto *header = new (mapping_.data()) SharedStateHeader{};
+        std::copy(std::begin(shared_state::MAGIC), std::end(shared_state::MAGIC), header->magic);
+        header->slotCount = slotCount;
+        header->maxBullets = maxBullets;
+        header->slotSize = static_cast<std::uint32_t>(sharedSlotSize(maxBullets));
+        header->version = shared_state::VERSION;
+        for (std::uint32_t i = 0; i < slotCount; i++) {
+            auto *frame = new (slot(i)) SharedFrameHeader{};
+            frame->tick = -1;
+        }
+        return true;
+    }
+    void close() { mapping_.unmap(); }
+    bool enabled() const { return mapping_.data() != nullptr; }
+    const std::string &error() const { return mapping_.error(); }
+
+    /// @brief Publish the state after the given number of ticks
+    void publish(int tick, const GameState &gameState) {
+        SharedStateHeader &header = this->header();
+        unsigned char *slotData = slot(static_cast<std::uint32_t>(tick) % header.slotCount);
+        auto *frame = reinterpret_cast<SharedFrameHeader *>(slotData);
+        auto *bullets = reinterpret_cast<SharedBullet *>(slotData + sizeof(SharedFrameHeader));
+
+        std::uint32_t sequence = frame->sequence.load(std::memory_order_relaxed);
+        frame->sequence.store(sequence + 1, std::memory_order_relaxed);
+        // Keep the writes below from becoming visible before the odd sequence
+        std::atomic_thread_fence(std::memory_order_release);
+
+        frame->tick = tick;
+        frame->health = gameState.health;
+        frame->bossHealth = gameState.bossHealth;
+        frame->playerX = gameState.playerObject.currentPosition.x;
+        frame->playerY = gameState.playerObject.currentPosition.y;
+        frame->bossX = gameState.bossObject.currentPosition.x;
+        frame->bossY = gameState.bossObject.currentPosition.y;
+        frame->cameraX = gameState.cameraOffset.x;
+        frame->cameraY = gameState.cameraOffset.y;
+        std::uint32_t dropped = 0;
+        frame->enemyBulletCount = writeBullets(gameState.enemyBulletObjects, bullets, dropped);
+        frame->playerBulletCount =
+            writeBullets(gameState.playerBulletObjects, bullets + header.maxBullets, dropped);
+        frame->droppedBullets = dropped;
+
+        frame->sequence.store(sequence + 2, std::memory_order_release);
+        header.published.store(static_cast<std::uint64_t>(tick) + 1, std::memory_order_release);
+    }
+
+  private:
+    template <typename Bullet>
+    std::uint32_t writeBullets(const std::vector<Bullet> &source, SharedBullet *destination,
+                               std::uint32_t &dropped) {
+        std::uint32_t capacity = header().maxBullets;
+        auto count = static_cast<std::uint32_t>(std::min<std::size_t>(source.size(), capacity));
+        for (std::uint32_t i = 0; i < count; i++) {
+            destination[i] = {source[i].currentPosition.x, source[i].currentPosition.y};
+        }
+        dropped += static_cast<std::uint32_t>(source.size()) - count;
+        return count;
+    }
+
+    SharedStateHeader &header() { return *reinterpret_cast<SharedStateHeader *>(mapping_.data()); }
+    unsigned char *slot(std::uint32_t index) {
+        return mapping_.data() + sharedHeaderSize() + std::size_t{index} * header().slotSize;
+    }
+
+    SharedMapping mapping_;
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include "alloc_tracker.hpp"
+#include "resolution_scaler.hpp"
+
+/// @brief Runtime counters shown on the stats surface
+struct Stats {
+    /// @brief Drawables submitted for drawing in the last frame
+    int drawn = 0;
+    /// @brief Drawables skipped by view culling in the last frame
+    int culled = 0;
+    /// @brief GL state changes made by the render queue in the last frame
+    int programBinds = 0;
+    int colorChanges = 0;
+    int batches = 0;
+    /// @brief Heap allocations of all threads in the last frame; zero unless the tracker is linked
+    std::uint64_t allocations = 0;
+    std::uint64_t allocatedBytes = 0;
+    /// @brief Input-to-present latency percentiles of the session in ms; zero until measured
+    double inputLatencyP50 = 0.0;
+    double inputLatencyP95 = 0.0;
+    double inputLatencyP99 = 0.0;
+    /// @brief Render scale of dynamic resolution, zero while it is off
+    float resolutionScale = 0.0f;
+    int resolutionChanges = 0;
+    ResolutionScaler::Decision lastResolutionChange;
+    /// @brief Time from main() to the first present and the part spent building shader programs
+    double startupMilliseconds = 0.0;
+    double shaderMilliseconds = 0.0;
+    int shadersFromCache = 0;
+    int shadersCompiled = 0;
+
+    /// @brief Reset the per-frame counters
+    void beginFrame() {
+        drawn = 0;
+        culled = 0;
+    }
+
+    void print(std::ostream &out) const {
+        out << "[stats] drawn: " << drawn << ", culled: " << culled << '\n';
+        out << "[stats] program binds: " << programBinds << ", color changes: " << colorChanges
+            << ", batches: " << batches << '\n';
+        if (ALLOC_TRACKER_ENABLED) {
+            out << "[stats] allocations: " << allocations << " (" << allocatedBytes
+                << " bytes)\n";
+        }
+        if (inputLatencyP99 > 0.0) {
+            out << "[stats] input latency p50: " << inputLatencyP50 << " ms, p95: "
+                << inputLatencyP95 << " ms, p99: " << inputLatencyP99 << " ms\n";
+        }
+        if (resolutionScale > 0.0f) {
+            out << "[stats] resolution scale: " << resolutionScale * 100.0f << "% ("
+                << resolutionChanges << " changes";
+            if (resolutionChanges > 0) {
+                const ResolutionScaler::Decision &last = lastResolutionChange;
+                out << ", last at frame " << last.frame << ": " << last.from * 100.0f << "% -> "
+                    << last.to * 100.0f << "% at " << last.averageMilliseconds << " ms";
+            }
+            out << ")\n";
+        }
+        if (startupMilliseconds > 0.0) {
+            out << "[stats] startup: " << startupMilliseconds << " ms to the first frame, shaders "
+                << shaderMilliseconds << " ms (" << shadersFromCache << " from cache, "
+                << shadersCompiled << " compiled)\n";
+        }
+    }
+};
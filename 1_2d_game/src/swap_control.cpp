@@ -0,0 +1,31 @@
+#include <GL/glew.h>
+#if defined(_WIN32)
+#include <GL/wglew.h>
+#elif defined(__APPLE__)
+#include <OpenGL/OpenGL.h>
+#else
+#include <GL/glxew.h>
+#endif
+#include "swap_control.hpp"
+
+bool setSwapInterval(int interval) {
+#if defined(_WIN32)
+    return WGLEW_EXT_swap_control && wglSwapIntervalEXT(interval) != FALSE;
+#elif defined(__APPLE__)
+    GLint value = interval;
+    return CGLSetParameter(CGLGetCurrentContext(), kCGLCPSwapInterval, &value) == kCGLNoError;
+#else
+    Display *display = glXGetCurrentDisplay();
+    GLXDrawable drawable = glXGetCurrentDrawable();
+    if (GLXEW_EXT_swap_control && display != nullptr && drawable != 0) {
+        glXSwapIntervalEXT(display, drawable, interval);
+        return true;
+    }
+    if (GLXEW_MESA_swap_control)
+        return glXSwapIntervalMESA(static_cast<unsigned>(interval)) == 0;
+    // SGI swap control cannot turn vsync off
+    if (GLXEW_SGI_swap_control && interval > 0)
+        return glXSwapIntervalSGI(interval) == 0;
+    return false;
+#endif
+}
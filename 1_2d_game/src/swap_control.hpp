@@ -0,0 +1,10 @@
+#pragma once
+
+// Swap interval control. Kept in swap_control.cpp so the window system headers it needs (X11
+// declares its own Drawable) stay out of the game's translation unit.
+
+/// @brief Set how many vertical blanks a buffer swap waits for on the current context
+/// @details Uses WGL_EXT_swap_control, CGL or one of the GLX swap control extensions; call after
+/// glewInit(). 0 lets swaps return immediately.
+/// @return false if the platform offers no way to set the interval
+bool setSwapInterval(int interval);
@@ -0,0 +1,112 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// @brief Fixed set of worker threads that split index ranges between them
+/// @details parallelFor does not allocate, so it can be used on the per-frame hot path.
+class ThreadPool {
+  public:
+    /// @param threadCount Total number of threads including the caller; 0 picks the core count
+    explicit ThreadPool(unsigned threadCount = 0) {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 1; i < threadCount; i++) {
+            workers_.emplace_back([this] { workerLoop(); });
+        }
+    }
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+            generation_++;
+        }
+        wake_.notify_all();
+        for (std::thread &worker : workers_) {
+            worker.join();
+        }
+    }
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// @brief Number of threads that run tasks, including the caller of parallelFor
+    unsigned threadCount() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    /// @brief Call task(i) for every i in [0, count) and wait until all calls returned
+    /// @tparam F Callable taking a std::size_t index; must be safe to call concurrently
+    template <typename F> void parallelFor(std::size_t count, F &&task) {
+        if (count == 0)
+            return;
+        if (workers_.empty() || count == 1) {
+            for (std::size_t i = 0; i < count; i++) {
+                task(i);
+            }
+            return;
+        }
+
+        // F is a reference type when task is an lvalue; the context points at the callable itself
+        using Task = std::remove_reference_t<F>;
+        {
+            std::lock_guard lock(mutex_);
+            task_ = [](void *context, std::size_t index) {
+                (*static_cast<Task *>(context))(index);
+            };
+            taskContext_ = const_cast<void *>(static_cast<const void *>(std::addressof(task)));
+            count_ = count;
+            next_.store(0);
+            busy_ = workers_.size();
+            generation_++;
+        }
+        wake_.notify_all();
+
+        runTasks();
+
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [this] { return busy_ == 0; });
+    }
+
+  private:
+    void runTasks() {
+        for (std::size_t i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1)) {
+            task_(taskContext_, i);
+        }
+    }
+
+    void workerLoop() {
+        std::size_t seenGeneration = 0;
+        while (true) {
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [&] { return generation_ != seenGeneration; });
+                seenGeneration = generation_;
+                if (stopping_)
+                    return;
+            }
+            runTasks();
+            {
+                std::lock_guard lock(mutex_);
+                busy_--;
+            }
+            done_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::size_t generation_ = 0;
+    std::size_t busy_ = 0;
+    bool stopping_ = false;
+
+    void (*task_)(void *, std::size_t) = nullptr;
+    void *taskContext_ = nullptr;
+    std::size_t count_ = 0;
+    std::atomic<std::size_t> next_{0};
+};
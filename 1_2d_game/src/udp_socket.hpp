@@ -0,0 +1,147 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#define UDP_SOCKET_SUPPORTED 1
+#else
+#define UDP_SOCKET_SUPPORTED 0
+#endif
+
+/// @brief IPv4 address and port of a datagram peer
+struct UdpAddress {
+    std::uint32_t host = 0;
+    std::uint16_t port = 0;
+
+    bool operator==(const UdpAddress &) const = default;
+    std::string toString() const {
+        return std::to_string(host >> 24) + '.' + std::to_string((host >> 16) & 0xFF) + '.' +
+               std::to_string((host >> 8) & 0xFF) + '.' + std::to_string(host & 0xFF) + ':' +
+               std::to_string(port);
+    }
+};
+
+/// @brief 127.0.0.1 with the given port
+inline UdpAddress loopbackAddress(std::uint16_t port) { return {0x7F000001u, port}; }
+
+/// @brief Non-blocking UDP socket bound to the loopback interface
+/// @details POSIX only; elsewhere open() fails and says so in error().
+class UdpSocket {
+  public:
+    static constexpr int RECEIVE_BUFFER_BYTES = 4 << 20;
+
+    UdpSocket() = default;
+    ~UdpSocket() { close(); }
+    UdpSocket(const UdpSocket &) = delete;
+    UdpSocket &operator=(const UdpSocket &) = delete;
+
+    /// @param port Local port to bind; 0 picks a free one
+    bool open(std::uint16_t port) {
+#if UDP_SOCKET_SUPPORTED
+        close();
+        fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd_ < 0)
+            return fail("socket");
+        sockaddr_in address = toSockaddr(loopbackAddress(port));
+        if (bind(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK) != 0) {
+            fail("bind to port " + std::to_string(port));
+            close();
+            return false;
+        }
+        // A full snapshot of a big game arrives as a burst of datagrams. Best effort: the kernel
+        // silently caps the size at net.core.rmem_max
+        int receiveBuffer = RECEIVE_BUFFER_BYTES;
+        setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+        return true;
+#else
+        (void)port;
+        error_ = "UDP replication needs a POSIX system";
+        return false;
+#endif
+    }
+
+    void close() {
+#if UDP_SOCKET_SUPPORTED
+        if (fd_ >= 0)
+            ::close(fd_);
+#endif
+        fd_ = -1;
+    }
+    bool isOpen() const { return fd_ >= 0; }
+
+    /// @brief Local address, useful after binding port 0
+    UdpAddress localAddress() const {
+#if UDP_SOCKET_SUPPORTED
+        sockaddr_in address{};
+        socklen_t length = sizeof(address);
+        if (fd_ >= 0 && getsockname(fd_, reinterpret_cast<sockaddr *>(&address), &length) == 0)
+            return fromSockaddr(address);
+#endif
+        return {};
+    }
+
+    /// @return false if the datagram could not be queued
+    bool send(const UdpAddress &to, const void *data, std::size_t size) {
+#if UDP_SOCKET_SUPPORTED
+        sockaddr_in address = toSockaddr(to);
+        return sendto(fd_, data, size, 0, reinterpret_cast<sockaddr *>(&address),
+                      sizeof(address)) == static_cast<ssize_t>(size);
+#else
+        (void)to;
+        (void)data;
+        (void)size;
+        return false;
+#endif
+    }
+
+    /// @brief Take the next pending datagram without waiting
+    /// @return Size of the datagram, or 0 if none is pending
+    std::size_t receive(void *buffer, std::size_t capacity, UdpAddress &from) {
+#if UDP_SOCKET_SUPPORTED
+        sockaddr_in address{};
+        socklen_t length = sizeof(address);
+        ssize_t size = recvfrom(fd_, buffer, capacity, 0, reinterpret_cast<sockaddr *>(&address),
+                                &length);
+        if (size <= 0)
+            return 0;
+        from = fromSockaddr(address);
+        return static_cast<std::size_t>(size);
+#else
+        (void)buffer;
+        (void)capacity;
+        (void)from;
+        return 0;
+#endif
+    }
+
+    const std::string &error() const { return error_; }
+
+  private:
+#if UDP_SOCKET_SUPPORTED
+    static sockaddr_in toSockaddr(const UdpAddress &address) {
+        sockaddr_in result{};
+        result.sin_family = AF_INET;
+        result.sin_addr.s_addr = htonl(address.host);
+        result.sin_port = htons(address.port);
+        return result;
+    }
+    static UdpAddress fromSockaddr(const sockaddr_in &address) {
+        return {ntohl(address.sin_addr.s_addr), ntohs(address.sin_port)};
+    }
+    bool fail(const std::string &what) {
+        error_ = what + " failed: " + std::strerror(errno);
+        return false;
+    }
+#endif
+
+    int fd_ = -1;
+    std::string error_;
+};
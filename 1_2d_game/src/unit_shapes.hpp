@@ -0,0 +1,67 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "render_queue.hpp"
+
+/// @brief Triangle lists (GL_TRIANGLES) of the render queue's shapes at unit size
+/// @details Circles have radius 1 and rects and triangles edge length 1, all centered at the
+/// origin, so a command's shape is its unit shape scaled by the command's size and moved to its
+/// center. The vertices are those of the emit functions in utils.hpp. A circle table is built the
+/// first time its segment count is requested.
+class UnitShapes {
+  public:
+    UnitShapes()
+        : rect_{{{-0.5f, 0.5f},
+                 {-0.5f, -0.5f},
+                 {0.5f, -0.5f},
+                 {-0.5f, 0.5f},
+                 {0.5f, -0.5f},
+                 {0.5f, 0.5f}}},
+          triangle_{{{0.0f, 0.5f}, {-0.5f, -0.5f}, {0.5f, -0.5f}}} {}
+
+    const std::vector<glm::vec2> &circle(int segments) {
+        std::vector<glm::vec2> &vertices = circles_[static_cast<std::uint8_t>(segments)];
+        if (vertices.empty() && segments > 0) {
+            glm::vec2 previous(1.0f, 0.0f);
+            for (int i = 1; i <= segments; i++) {
+                float angle = static_cast<float>(2.0f * std::numbers::pi * i / segments);
+                glm::vec2 next(std::cos(angle), std::sin(angle));
+                vertices.push_back(glm::vec2(0.0f));
+                vertices.push_back(previous);
+                vertices.push_back(next);
+                previous = next;
+            }
+        }
+        return vertices;
+    }
+
+    /// @brief Shape of a primitive; SDF circles get their fallback circle
+    const std::vector<glm::vec2> &shape(Primitive primitive, int segments) {
+        switch (primitive) {
+        case Primitive::Rect:
+            return rect_;
+        case Primitive::Triangle:
+            return triangle_;
+        case Primitive::Circle:
+        case Primitive::SdfCircle:
+            break;
+        }
+        return circle(segments);
+    }
+
+  private:
+    std::array<std::vector<glm::vec2>, 256> circles_;
+    std::vector<glm::vec2> rect_;
+    std::vector<glm::vec2> triangle_;
+};
+
+/// @brief Append a unit shape scaled by size and moved to center
+inline void appendShape(std::vector<glm::vec2> &vertices, const std::vector<glm::vec2> &shape,
+                        glm::vec2 center, float size) {
+    for (glm::vec2 vertex : shape) {
+        vertices.push_back(center + vertex * size);
+    }
+}
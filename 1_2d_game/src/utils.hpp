@@ -1,39 +1,360 @@
+#pragma once
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
 #include <numbers>
+#include "render.hpp"
+#include "render_queue.hpp"
+#include "shader.hpp"
+#include "unit_shapes.hpp"
 
-void drawCircle(glm::fvec2 center, float radius, int numSegments, glm::fvec3 color) {
-    glColor3f(color.x, color.y, color.z);
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(center.x, center.y);
-    for (int i = 0; i <= numSegments; i++) {
+// Vertex emitters shared by the immediate helpers and the render queue; call inside glBegin/glEnd
+
+/// @brief Emit a circle as independent triangles (GL_TRIANGLES) so consecutive circles batch
+inline void emitCircleTriangles(glm::fvec2 center, float radius, int numSegments) {
+    float previousX = center.x + radius;
+    float previousY = center.y;
+    for (int i = 1; i <= numSegments; i++) {
         float angle = static_cast<float>(2.0f * std::numbers::pi * i / numSegments);
         float x = center.x + radius * std::cos(angle);
         float y = center.y + radius * std::sin(angle);
+        glVertex2f(center.x, center.y);
+        glVertex2f(previousX, previousY);
         glVertex2f(x, y);
+        previousX = x;
+        previousY = y;
     }
-    glEnd();
 }
 
-void drawRect(glm::fvec2 center, float size, glm::fvec3 color) {
+/// @brief Emit an axis-aligned square as two triangles (GL_TRIANGLES)
+inline void emitRect(glm::fvec2 center, float size) {
     float half = size / 2.0f;
-
-    glColor3f(color.x, color.y, color.z);
-    glBegin(GL_TRIANGLES);
     glVertex2f(center.x - half, center.y + half);
     glVertex2f(center.x - half, center.y - half);
     glVertex2f(center.x + half, center.y - half);
     glVertex2f(center.x - half, center.y + half);
     glVertex2f(center.x + half, center.y - half);
     glVertex2f(center.x + half, center.y + half);
-    glEnd();
 }
 
-void drawTriangle(glm::fvec2 center, float size, glm::fvec3 color) {
-    glColor3f(color.x, color.y, color.z);
-    glBegin(GL_TRIANGLES);
+/// @brief Emit an upward-pointing triangle (GL_TRIANGLES)
+inline void emitTriangle(glm::fvec2 center, float size) {
     glVertex2f(center.x, center.y + size / 2);
     glVertex2f(center.x - size / 2, center.y - size / 2);
     glVertex2f(center.x + size / 2, center.y - size / 2);
+}
+
+/// @brief Emit the bounding quad of a circle with unit-circle coordinates in texcoord 0 (GL_QUADS)
+inline void emitSdfQuad(glm::fvec2 center, float radius) {
+    glTexCoord2f(-1.0f, -1.0f);
+    glVertex2f(center.x - radius, center.y - radius);
+    glTexCoord2f(1.0f, -1.0f);
+    glVertex2f(center.x + radius, center.y - radius);
+    glTexCoord2f(1.0f, 1.0f);
+    glVertex2f(center.x + radius, center.y + radius);
+    glTexCoord2f(-1.0f, 1.0f);
+    glVertex2f(center.x - radius, center.y + radius);
+}
+
+inline void drawCircle(glm::fvec2 center, float radius, int numSegments, glm::fvec3 color) {
+    glColor3f(color.x, color.y, color.z);
+    glBegin(GL_TRIANGLE_FAN);
+    glVertex2f(center.x, center.y);
+    for (int i = 0; i <= numSegments; i++) {
+        float angle = static_cast<float>(2.0f * std::numbers::pi * i / numSegments);
+        float x = center.x + radius * std::cos(angle);
+        float y = center.y + radius * std::sin(angle);
+        glVertex2f(x, y);
+    }
+    glEnd();
+}
+
+inline void drawRect(glm::fvec2 center, float size, glm::fvec3 color) {
+    glColor3f(color.x, color.y, color.z);
+    glBegin(GL_TRIANGLES);
+    emitRect(center, size);
+    glEnd();
+}
+
+inline void drawTriangle(glm::fvec2 center, float size, glm::fvec3 color) {
+    glColor3f(color.x, color.y, color.z);
+    glBegin(GL_TRIANGLES);
+    emitTriangle(center, size);
     glEnd();
 }
+
+inline const char *SDF_CIRCLE_VERTEX_SHADER = R"(
+#version 120
+uniform mat4 viewProjection;
+varying vec2 local;
+void main() {
+    local = gl_MultiTexCoord0.xy;
+    gl_FrontColor = gl_Color;
+    gl_Position = viewProjection * gl_Vertex;
+}
+)";
+
+// Coverage comes from the signed distance to the unit circle, smoothed over one pixel footprint.
+inline const char *SDF_CIRCLE_FRAGMENT_SHADER = R"(
+#version 120
+varying vec2 local;
+void main() {
+    float distance = length(local) - 1.0;
+    float width = fwidth(distance);
+    float coverage = 1.0 - smoothstep(-width, 0.0, distance);
+    if (coverage <= 0.0)
+        discard;
+    gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * coverage);
+}
+)";
+
+inline GLuint sdfCircleProgram = 0;
+inline GLint sdfViewProjectionLocation = -1;
+
+/// @brief Build the SDF circle shader. Requires blending to be enabled for anti-aliased edges.
+/// @return false if shaders are unavailable; drawSdfCircle then falls back to triangle fans
+inline bool initSdfCircles(ShaderManager &shaders) {
+    sdfCircleProgram =
+        shaders.program("sdf_circle", SDF_CIRCLE_VERTEX_SHADER, SDF_CIRCLE_FRAGMENT_SHADER);
+    if (sdfCircleProgram == 0)
+        return false;
+    sdfViewProjectionLocation = glGetUniformLocation(sdfCircleProgram, "viewProjection");
+    return true;
+}
+
+
+/// @brief Draw an anti-aliased circle as a single quad shaded by its signed distance field
+/// @param fallbackSegments Segment count of the triangle fan used when the shader is unavailable
+inline void drawSdfCircle(glm::fvec2 center, float radius, int fallbackSegments,
+                          glm::fvec3 color) {
+    if (sdfCircleProgram == 0) {
+        drawCircle(center, radius, fallbackSegments, color);
+        return;
+    }
+
+    glUseProgram(sdfCircleProgram);
+    glColor3f(color.x, color.y, color.z);
+    glBegin(GL_QUADS);
+    emitSdfQuad(center, radius);
+    glEnd();
+    glUseProgram(0);
+}
+
+/// @brief Shadow of the GL state touched by queue execution, used to skip redundant changes
+struct GlStateCache {
+    GLuint program = 0;
+    /// @brief Mode of the currently open glBegin, or GL_NONE outside a batch
+    GLenum batchMode = GL_NONE;
+    glm::fvec3 color{-1.0f};
+    /// @brief Last view-projection uploaded to the SDF circle program
+    glm::mat4 sdfViewProjection{0.0f};
+
+    // Work done since the last resetCounters(), reported on the stats surface
+    int programBinds = 0;
+    int colorChanges = 0;
+    int batches = 0;
+
+    void resetCounters() {
+        programBinds = 0;
+        colorChanges = 0;
+        batches = 0;
+    }
+    /// @brief Forget the shadowed color after GL calls outside the cache changed it
+    void invalidateColor() { color = glm::fvec3(-1.0f); }
+
+    void endBatch() {
+        if (batchMode != GL_NONE) {
+            glEnd();
+            batchMode = GL_NONE;
+        }
+    }
+    void beginBatch(GLenum mode) {
+        if (batchMode == mode)
+            return;
+        endBatch();
+        glBegin(mode);
+        batchMode = mode;
+        batches++;
+    }
+    void useProgram(GLuint newProgram) {
+        if (program == newProgram)
+            return;
+        endBatch();
+        glUseProgram(newProgram);
+        program = newProgram;
+        programBinds++;
+    }
+    void setColor(glm::fvec3 newColor) {
+        if (color == newColor)
+            return;
+        glColor3f(newColor.x, newColor.y, newColor.z);
+        color = newColor;
+        colorChanges++;
+    }
+    void uploadViewProjection(const glm::mat4 &viewProjection) {
+        if (sdfCircleProgram == 0 || sdfViewProjection == viewProjection)
+            return;
+        useProgram(sdfCircleProgram);
+        glUniformMatrix4fv(sdfViewProjectionLocation, 1, GL_FALSE, glm::value_ptr(viewProjection));
+        sdfViewProjection = viewProjection;
+    }
+};
+
+/// @brief Upload the camera transform for both fixed-function and shader draws
+/// @param context The render context of the current frame
+/// @param cache GL state cache; the shader uniform is only re-uploaded when the camera moved
+inline void applyRenderContext(const RenderContext &context, GlStateCache &cache) {
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(glm::value_ptr(context.viewProjection));
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    cache.uploadViewProjection(context.viewProjection);
+}
+
+/// @brief Draw every command of a sorted queue, batching consecutive commands of the same mode
+/// @param queue The queue to execute, normally sorted with RenderQueue::sort first
+/// @param cache GL state cache; left with no open batch and no bound program
+inline void executeRenderQueue(const RenderQueue &queue, GlStateCache &cache) {
+    for (const RenderCommand &command : queue.commands()) {
+        Primitive primitive = command.primitive;
+        if (primitive == Primitive::SdfCircle && sdfCircleProgram == 0)
+            primitive = Primitive::Circle;
+
+        switch (primitive) {
+        case Primitive::SdfCircle:
+            cache.useProgram(sdfCircleProgram);
+            cache.beginBatch(GL_QUADS);
+            cache.setColor(command.color);
+            emitSdfQuad(command.center, command.size);
+            break;
+        case Primitive::Circle:
+            cache.useProgram(0);
+            cache.beginBatch(GL_TRIANGLES);
+            cache.setColor(command.color);
+            emitCircleTriangles(command.center, command.size, command.segments);
+            break;
+        case Primitive::Rect:
+            cache.useProgram(0);
+            cache.beginBatch(GL_TRIANGLES);
+            cache.setColor(command.color);
+            emitRect(command.center, command.size);
+            break;
+        case Primitive::Triangle:
+            cache.useProgram(0);
+            cache.beginBatch(GL_TRIANGLES);
+            cache.setColor(command.color);
+            emitTriangle(command.center, command.size);
+            break;
+        }
+    }
+    cache.endBatch();
+    cache.useProgram(0);
+}
+
+/// @brief How the render queue's geometry is sent to GL
+enum class RenderBackend { Immediate, DisplayLists, VertexArrays };
+
+constexpr const char *renderBackendName(RenderBackend backend) {
+    switch (backend) {
+    case RenderBackend::Immediate:
+        return "immediate";
+    case RenderBackend::DisplayLists:
+        return "lists";
+    case RenderBackend::VertexArrays:
+        return "arrays";
+    }
+    return "";
+}
+
+/// @brief Fixed-function backends for legacy contexts, where shader paths are unavailable
+/// @details Both draw the unit shapes of UnitShapes, so no trigonometry runs per command. SDF
+/// circles are drawn as their fallback circles.
+class LegacyRenderer {
+  public:
+    /// @brief Draw each command as a translated and scaled call of its shape's display list
+    /// @details Each shape is compiled into a display list the first time it is drawn.
+    void executeDisplayLists(const RenderQueue &queue, GlStateCache &cache) {
+        cache.useProgram(0);
+        cache.endBatch();
+        glMatrixMode(GL_MODELVIEW);
+        for (const RenderCommand &command : queue.commands()) {
+            GLuint list = shapeList(command.primitive, command.segments);
+            cache.setColor(command.color);
+            glPushMatrix();
+            glTranslatef(command.center.x, command.center.y, 0.0f);
+            glScalef(command.size, command.size, 1.0f);
+            glCallList(list);
+            glPopMatrix();
+            cache.batches++;
+        }
+    }
+
+    /// @brief Transform every command into one client-side vertex array and draw it at once
+    /// @details The arrays keep their capacity, so a steady-state frame does not allocate.
+    void executeVertexArrays(const RenderQueue &queue, GlStateCache &cache) {
+        cache.useProgram(0);
+        cache.endBatch();
+        vertices_.clear();
+        colors_.clear();
+        for (const RenderCommand &command : queue.commands()) {
+            appendShape(vertices_, shapes_.shape(command.primitive, command.segments),
+                        command.center, command.size);
+            colors_.resize(vertices_.size(), command.color);
+        }
+        if (vertices_.empty())
+            return;
+
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(2, GL_FLOAT, 0, vertices_.data());
+        glColorPointer(3, GL_FLOAT, 0, colors_.data());
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices_.size()));
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        // Per-vertex colors leave the current color undefined
+        cache.invalidateColor();
+        cache.batches++;
+    }
+
+  private:
+    GLuint shapeList(Primitive primitive, int segments) {
+        GLuint &list = primitive == Primitive::Rect       ? rectList_
+                       : primitive == Primitive::Triangle ? triangleList_
+                                                          : circleLists_[segments & 0xFF];
+        if (list != 0)
+            return list;
+        list = glGenLists(1);
+        glNewList(list, GL_COMPILE);
+        glBegin(GL_TRIANGLES);
+        for (glm::vec2 vertex : shapes_.shape(primitive, segments)) {
+            glVertex2f(vertex.x, vertex.y);
+        }
+        glEnd();
+        glEndList();
+        return list;
+    }
+
+    UnitShapes shapes_;
+    std::array<GLuint, 256> circleLists_{};
+    GLuint rectList_ = 0;
+    GLuint triangleList_ = 0;
+    std::vector<glm::vec2> vertices_;
+    std::vector<glm::vec3> colors_;
+};
+
+/// @brief Draw a sorted queue with the given backend
+inline void executeRenderQueue(const RenderQueue &queue, GlStateCache &cache,
+                               RenderBackend backend, LegacyRenderer &legacy) {
+    switch (backend) {
+    case RenderBackend::Immediate:
+        executeRenderQueue(queue, cache);
+        break;
+    case RenderBackend::DisplayLists:
+        legacy.executeDisplayLists(queue, cache);
+        break;
+    case RenderBackend::VertexArrays:
+        legacy.executeVertexArrays(queue, cache);
+        break;
+    }
+}
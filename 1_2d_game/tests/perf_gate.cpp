@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../src/collision.hpp"
+#include "../src/frame_arena.hpp"
+#include "../src/game.hpp"
+#include "../src/scenario.hpp"
+#include "../src/snapshot.hpp"
+
+// Performance regression gate.
+//
+// Runs fixed, deterministic scenarios several times, rejects outlier runs, and compares the median
+// with the checked-in baseline. Exits with 1 when a scenario got slower than the tolerance allows
+// or the baseline is missing, and with 77 (reported by CTest as skipped) in unoptimized builds,
+// whose timings mean nothing.
+//
+// Machines differ, and virtual machines speed up and slow down as a whole by tens of percent
+// between processes, so each run also times a reference workload that uses no game code, and
+// scenarios are gated on their time relative to it. The baseline holds only these ratios and the
+// spread of the recorded runs. A quiet run is held to half the tolerance; noise widens that to
+// three times the larger spread, but never beyond the tolerance itself.
+//
+//   perf_gate --baseline FILE [--scenario NAME] [--tolerance 0.15] [--runs 7]
+//   perf_gate --baseline FILE --record      (re-measure every scenario and rewrite the baseline)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int SKIP_RETURN_CODE = 77;
+constexpr int BULLETS = 10000;
+constexpr int PLAYER_BULLETS = 1000;
+constexpr int WARM_UP_TICKS = 5;
+constexpr int BATCHES = 5;
+constexpr int TICKS_PER_ROUND = 10;
+/// @brief Shortest timed duration of a batch; shorter ones are dominated by timer and clock noise
+constexpr double MIN_BATCH_MS = 50.0;
+
+volatile std::uint64_t sink = 0;
+
+/// @brief Fastest batch of a run, per step, in ms
+/// @details A batch repeats rounds of stepsPerRound steps until it has timed at least
+/// MIN_BATCH_MS. Taking the fastest batch filters out preemption and other one-off stalls inside
+/// a run; runScenario() then handles noise between runs.
+/// @param setup Untimed, called before each round so every round starts from the same state
+template <typename Setup, typename Step>
+double fastestBatch(int stepsPerRound, Setup &&setup, Step &&step) {
+    double best = 0.0;
+    for (int batch = 0; batch < BATCHES; batch++) {
+        double milliseconds = 0.0;
+        int steps = 0;
+        while (milliseconds < MIN_BATCH_MS) {
+            setup();
+            auto start = Clock::now();
+            for (int i = 0; i < stepsPerRound; i++) {
+                step();
+            }
+            milliseconds += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            steps += stepsPerRound;
+        }
+        double perStep = milliseconds / steps;
+        best = batch == 0 ? perStep : std::min(best, perStep);
+    }
+    return best;
+}
+
+/// @brief Simulation (update and collision) of the 10k-bullet field, in ms per tick
+double measureTick() {
+    GameState initial(100, 500);
+    populateBulletField(initial, BULLETS, PLAYER_BULLETS, 1);
+    GameState gameState = initial;
+    int tick = 0;
+    auto step = [&] {
+        updateGame(gameState, tick * TICK_MS);
+        countHits(gameState);
+        tick++;
+    };
+    auto setup = [&] {
+        // Bullets leave the field over time; restart so every round simulates the same ticks
+        gameState = initial;
+        tick = 0;
+        for (int i = 0; i < WARM_UP_TICKS; i++) {
+            step();
+        }
+    };
+    return fastestBatch(TICKS_PER_ROUND, setup, step);
+}
+
+/// @brief Culling, submission and sorting of the 10k-bullet field, in ms per frame
+double measureRenderPrep() {
+    GameState gameState(100, 500);
+    populateBulletField(gameState, BULLETS, PLAYER_BULLETS, 2);
+    FrameArena arena;
+    Stats stats;
+    auto frame = [&] {
+        arena.reset();
+        RenderQueue queue(&arena);
+        queue.reserve(submitCapacity(gameState));
+        RenderContext context(gameState.cameraOffset, queue);
+        stats.beginFrame();
+        submitGame(gameState, context, stats);
+        queue.sort();
+        sink = sink + queue.commands().size();
+    };
+    for (int i = 0; i < WARM_UP_TICKS; i++) {
+        frame();
+    }
+    return fastestBatch(TICKS_PER_ROUND, [] {}, frame);
+}
+
+/// @brief detectCollision on object pairs across the 10k-bullet field, in ns per test
+double measureCollision() {
+    GameState gameState(100, 500);
+    populateBulletField(gameState, BULLETS, BULLETS, 3);
+    const auto &enemies = gameState.enemyBulletObjects;
+    const auto &players = gameState.playerBulletObjects;
+    auto sweep = [&] {
+        std::uint64_t hits = 0;
+        for (std::size_t i = 0; i < enemies.size(); i++) {
+            hits += detectCollision(enemies[i], players[(i * 7919) % players.size()]) ? 1 : 0;
+        }
+        sink = sink + hits;
+    };
+    sweep();
+    constexpr int SWEEPS_PER_ROUND = 50;
+    return fastestBatch(SWEEPS_PER_ROUND, [] {}, sweep) * 1e6 /
+           static_cast<double>(enemies.size());
+}
+
+/// @brief Restore the snapshot from 8 ticks ago and resimulate up to now, in ms per rollback
+/// @details The rollback netplay budget: this has to fit well inside one 16 ms frame.
+double measureRollback() {
+    constexpr int ROLLBACK_TICKS = 8;
+    GameState gameState(100, 500);
+    populateBulletField(gameState, BULLETS, PLAYER_BULLETS, 4);
+    SnapshotRing ring(ROLLBACK_TICKS + 1, BULLETS + PLAYER_BULLETS);
+    ring.save(0, gameState);
+    auto resimulate = [&] {
+        for (int tick = 0; tick < ROLLBACK_TICKS; tick++) {
+            advanceTick(gameState, TickInput{}, tick);
+            ring.save(tick + 1, gameState);
+        }
+    };
+    resimulate();
+    auto rollback = [&] {
+        ring.restore(0, gameState);
+        resimulate();
+    };
+    rollback();
+    return fastestBatch(1, [] {}, rollback);
+}
+
+/// @brief Float and memory work like the scenarios' over 10k points, using no game code
+double measureReference() {
+    std::vector<glm::vec2> initial;
+    for (int i = 0; i < BULLETS; i++) {
+        initial.emplace_back(static_cast<float>(i % 100) / 50.0f - 1.0f,
+                             static_cast<float>(i / 100) / 50.0f - 1.0f);
+    }
+    std::vector<glm::vec2> points;
+    auto step = [&] {
+        int inside = 0;
+        for (glm::vec2 &point : points) {
+            point = glm::vec2(point.x * 0.99f - point.y * 0.01f, point.y * 0.99f + point.x * 0.01f);
+            if (glm::dot(point, point) < 0.25f)
+                inside++;
+        }
+        sink = sink + static_cast<std::uint64_t>(inside);
+    };
+    return fastestBatch(TICKS_PER_ROUND, [&] { points = initial; }, step);
+}
+
+struct Scenario {
+    const char *name;
+    double (*measure)();
+};
+
+const Scenario SCENARIOS[] = {
+    {"tick_10k_ms", measureTick},
+    {"render_prep_10k_ms", measureRenderPrep},
+    {"collision_10k_ns", measureCollision},
+    {"rollback_8_10k_ms", measureRollback},
+};
+
+/// @brief Robust summary of the runs of a scenario
+struct Measurement {
+    /// @brief Median time, in the scenario's unit
+    double median;
+    /// @brief Median time relative to the reference workload timed in the same runs
+    double relative;
+    /// @brief Median absolute deviation of the relative times, relative to their median
+    double noise;
+};
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    std::size_t middle = values.size() / 2;
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+/// @brief Median of the runs left after dropping those more than 3 MADs from the median
+/// @param noise Set to the median absolute deviation of all runs, relative to their median
+double robustMedian(std::vector<double> runs, double &noise) {
+    double center = median(runs);
+    std::vector<double> deviations;
+    for (double run : runs) {
+        deviations.push_back(std::abs(run - center));
+    }
+    double deviation = median(deviations);
+    noise = deviation / center;
+    // Floor the spread at 1% so identical runs do not reject everything else
+    double spread = std::max(deviation, center * 0.01);
+    std::erase_if(runs, [&](double run) { return std::abs(run - center) > 3.0 * spread; });
+    return median(runs);
+}
+
+Measurement runScenario(const Scenario &scenario, int runs) {
+    std::vector<double> times;
+    std::vector<double> relativeTimes;
+    for (int run = 0; run < runs; run++) {
+        // Time the reference right before, so both see the same machine speed
+        double reference = measureReference();
+        times.push_back(scenario.measure());
+        relativeTimes.push_back(times.back() / reference);
+    }
+    Measurement measurement{};
+    double timeNoise = 0.0;
+    measurement.median = robustMedian(times, timeNoise);
+    measurement.relative = robustMedian(relativeTimes, measurement.noise);
+    return measurement;
+}
+
+/// @brief Read a flat JSON object of "name": number pairs
+std::map<std::string, double> readBaseline(const std::string &path) {
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::string text = contents.str();
+
+    std::map<std::string, double> baseline;
+    std::regex entry("\"([A-Za-z0-9_]+)\"\\s*:\\s*([-+0-9.eE]+)");
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), entry);
+         it != std::sregex_iterator(); ++it) {
+        baseline[(*it)[1].str()] = std::stod((*it)[2].str());
+    }
+    return baseline;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::string baselinePath;
+    std::string scenarioName;
+    double tolerance = 0.15;
+    int runs = 7;
+    bool record = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--baseline" && hasValue) {
+            baselinePath = argv[++i];
+        } else if (arg == "--scenario" && hasValue) {
+            scenarioName = argv[++i];
+        } else if (arg == "--tolerance" && hasValue) {
+            tolerance = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--runs" && hasValue) {
+            runs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--record") {
+            record = true;
+        } else {
+            baselinePath.clear();
+            break;
+        }
+    }
+    if (baselinePath.empty()) {
+        std::cerr << "Usage: " << argv[0]
+                  << " --baseline FILE [--scenario NAME] [--tolerance F] [--runs N]"
+                     " [--record]\n";
+        return 1;
+    }
+
+#ifndef NDEBUG
+    std::cout << "Skipped: perf tests need an optimized build (CMAKE_BUILD_TYPE=Release)\n";
+    return SKIP_RETURN_CODE;
+#endif
+
+    // Boss::update logs every spawn; keep that out of the timings and the test output
+    std::cout.setstate(std::ios::failbit);
+    auto report = [](const std::string &line) {
+        std::cout.clear();
+        std::cout << line << std::endl;
+        std::cout.setstate(std::ios::failbit);
+    };
+
+    if (record) {
+        std::ofstream out(baselinePath);
+        out << "{\n";
+        for (std::size_t i = 0; i < std::size(SCENARIOS); i++) {
+            Measurement measurement = runScenario(SCENARIOS[i], runs);
+            std::string name = SCENARIOS[i].name;
+            out << "  \"" << name << "_relative\": " << measurement.relative << ",\n";
+            out << "  \"" << name << "_noise\": " << measurement.noise
+                << (i + 1 < std::size(SCENARIOS) ? ",\n" : "\n");
+            std::ostringstream line;
+            line << "[perf] " << name << " = " << measurement.median << ", "
+                 << measurement.relative << "x reference (noise " << measurement.noise * 100.0
+                 << "%)";
+            report(line.str());
+        }
+        out << "}\n";
+        return out ? 0 : 1;
+    }
+
+    if (!std::ifstream(baselinePath)) {
+        report("[FAIL] no baseline at " + baselinePath + "; record one with perf_gate --baseline " +
+               baselinePath + " --record");
+        return 1;
+    }
+    std::map<std::string, double> baseline = readBaseline(baselinePath);
+    bool passed = true;
+    bool found = false;
+    for (const Scenario &scenario : SCENARIOS) {
+        if (!scenarioName.empty() && scenarioName != scenario.name)
+            continue;
+        found = true;
+        auto expected = baseline.find(std::string(scenario.name) + "_relative");
+        if (expected == baseline.end()) {
+            report(std::string("[perf] ") + scenario.name + ": no baseline in " + baselinePath);
+            passed = false;
+            continue;
+        }
+        Measurement measurement = runScenario(scenario, runs);
+        double recordedNoise = baseline[std::string(scenario.name) + "_noise"];
+        double noise = std::max(recordedNoise, measurement.noise);
+        double allowed = std::clamp(3.0 * noise, tolerance / 2.0, tolerance);
+        double ratio = measurement.relative / expected->second;
+        bool ok = ratio <= 1.0 + allowed;
+        std::ostringstream line;
+        line << (ok ? "[PASS] " : "[FAIL] ") << scenario.name << ": " << measurement.median << ", "
+             << measurement.relative << "x reference (baseline " << expected->second << "x, "
+             << (ratio - 1.0) * 100.0 << "%, tolerance " << allowed * 100.0 << "%)";
+        if (ratio < 1.0 - allowed)
+            line << " -- faster than baseline, consider --record";
+        report(line.str());
+        passed = passed && ok;
+    }
+    if (!found) {
+        report("[perf] unknown scenario " + scenarioName);
+        return 1;
+    }
+    return passed ? 0 : 1;
+}
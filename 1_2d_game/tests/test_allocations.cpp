@@ -0,0 +1,107 @@
+#include <cstdint>
+#include <iostream>
+#include <memory_resource>
+#include "../src/alloc_tracker.hpp"
+#include "../src/frame_arena.hpp"
+#include "../src/game.hpp"
+#include "../src/soft_raster.hpp"
+
+/// @brief One tick of the headless driver: simulate, submit, rasterize
+void runTick(GameState &gameState, FrameArena &arena, SoftRasterizer &rasterizer, Stats &stats,
+             int tick) {
+    // Keep the player firing so both bullet vectors see spawns and removals
+    gameState.playerObject.tryAttack();
+    updateGame(gameState, tick * TICK_MS);
+    countHits(gameState);
+
+    arena.reset();
+    RenderQueue queue(&arena);
+    queue.reserve(submitCapacity(gameState));
+    RenderContext context(gameState.cameraOffset, queue);
+    stats.beginFrame();
+    submitGame(gameState, context, stats);
+    queue.sort();
+    rasterizer.clear(glm::fvec3(0.0f));
+    rasterizer.setViewProjection(context.viewProjection);
+    executeRenderQueue(queue, rasterizer);
+    rasterizer.flush();
+}
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running Allocation Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    // Test 1: The replaced operator new counts allocations
+    {
+        AllocationCounters before = allocationTotals();
+        // volatile keeps the compiler from eliding the new/delete pair
+        int *volatile value = new int(42);
+        AllocationCounters allocated = allocationTotals() - before;
+        delete value;
+        check("Test 1: operator new is tracked",
+              allocated.allocations == 1 && allocated.bytes == sizeof(int));
+    }
+
+    // Test 2: After warm-up, headless ticks make no heap allocations
+    {
+        GameState gameState(100, 500);
+        // Start small so the arena has to grow during warm-up
+        FrameArena arena(256);
+        SoftRasterizer rasterizer(200, 200, 4);
+        Stats stats;
+
+        constexpr int WARM_UP_TICKS = 300;
+        constexpr int MEASURED_TICKS = 1000;
+        int tick = 0;
+        for (; tick < WARM_UP_TICKS; tick++) {
+            runTick(gameState, arena, rasterizer, stats, tick);
+        }
+        AllocationCounters before = allocationTotals();
+        for (; tick < WARM_UP_TICKS + MEASURED_TICKS; tick++) {
+            runTick(gameState, arena, rasterizer, stats, tick);
+        }
+        AllocationCounters allocated = allocationTotals() - before;
+        std::cout << "  " << allocated.allocations << " allocations (" << allocated.bytes
+                  << " bytes) in " << MEASURED_TICKS << " ticks, " << stats.drawn
+                  << " objects drawn in the last\n";
+        check("Test 2: Zero allocations per tick after warm-up",
+              allocated.allocations == 0 && stats.drawn > 2);
+    }
+
+    // Test 3: Allocations aligned beyond the block's own alignment are aligned in memory
+    {
+        // Hand the arena a block that is 16 but not 64 byte aligned
+        alignas(64) static std::byte buffer[64 * 1024];
+        std::pmr::monotonic_buffer_resource upstream(buffer, sizeof(buffer),
+                                                     std::pmr::null_memory_resource());
+        static_cast<void>(upstream.allocate(16, 16));
+        FrameArena arena(1024, &upstream);
+        bool aligned = true;
+        // Mixed sizes, then more than the block holds, so overflow blocks are checked too
+        for (int i = 0; i < 40; i++) {
+            static_cast<void>(arena.allocate(static_cast<std::size_t>(i % 3 + 1), 1));
+            void *pointer = arena.allocate(64, 64);
+            aligned = aligned && reinterpret_cast<std::uintptr_t>(pointer) % 64 == 0;
+        }
+        check("Test 3: 64-byte alignment holds in main and overflow blocks",
+              aligned && arena.used() > arena.capacity());
+    }
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+
+    return (testsPassed == totalTests) ? 0 : 1;
+}
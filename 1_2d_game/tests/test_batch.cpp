@@ -0,0 +1,100 @@
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "../src/batch_env.hpp"
+#include "../src/input_replay.hpp"
+
+constexpr std::size_t ENVIRONMENTS = 300;
+constexpr int STEPS = 200;
+
+/// @brief Different, reproducible buttons for every game and step
+std::uint8_t scriptedButtons(std::size_t environment, int step) {
+    return static_cast<std::uint8_t>((environment * 7 + step / 9) % 32);
+}
+
+/// @brief Step a batch with the scripted inputs, returning the observations after every step
+std::vector<float> runBatch(BatchEnvironment &environment, int steps) {
+    std::vector<float> history;
+    std::vector<std::uint8_t> inputs(environment.size());
+    for (int step = 0; step < steps; step++) {
+        for (std::size_t i = 0; i < inputs.size(); i++) {
+            inputs[i] = scriptedButtons(i, step);
+        }
+        environment.step(inputs.data());
+        const float *observations = environment.observations();
+        history.insert(history.end(), observations,
+                       observations + environment.size() * observation::SIZE);
+    }
+    return history;
+}
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running Batch Environment Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    BatchConfig config;
+    config.initialBullets = 20;
+
+    // Test 1: Every game of the batch evolves like a game stepped on its own
+    {
+        BatchEnvironment environment(ENVIRONMENTS, config, 4);
+        runBatch(environment, STEPS);
+        bool matches = true;
+        for (std::size_t i : {std::size_t{0}, std::size_t{63}, std::size_t{64}, ENVIRONMENTS - 1}) {
+            GameState gameState(config.health, config.bossHealth);
+            gameState.logBossAttacks = false;
+            populateBulletField(gameState, config.initialBullets, 0,
+                                static_cast<std::uint32_t>(1 + i * 7919));
+            for (int step = 0; step < STEPS; step++) {
+                advanceTick(gameState, TickInput{scriptedButtons(i, step)}, step);
+            }
+            matches = matches && hashGameState(gameState) == hashGameState(environment.game(i));
+        }
+        check("Test 1: Batched games match games stepped alone", matches);
+    }
+
+    // Test 2: Results do not depend on the number of threads
+    {
+        BatchEnvironment serial(ENVIRONMENTS, config, 1);
+        BatchEnvironment parallel(ENVIRONMENTS, config, 4);
+        std::vector<float> serialHistory = runBatch(serial, STEPS);
+        std::vector<float> parallelHistory = runBatch(parallel, STEPS);
+        check("Test 2: Observations are identical on 1 and 4 threads",
+              serialHistory.size() == parallelHistory.size() &&
+                  std::memcmp(serialHistory.data(), parallelHistory.data(),
+                              serialHistory.size() * sizeof(float)) == 0);
+    }
+
+    // Test 3: Episodes end at maxTicks and the next step starts a new one
+    {
+        BatchConfig shortEpisodes;
+        shortEpisodes.maxTicks = 10;
+        BatchEnvironment environment(ENVIRONMENTS, shortEpisodes, 2);
+        runBatch(environment, 10);
+        bool endedTogether = true;
+        for (std::size_t i = 0; i < environment.size(); i++) {
+            endedTogether = endedTogether && environment.done()[i] == 1;
+        }
+        runBatch(environment, 1);
+        check("Test 3: Episodes end and reset automatically",
+              endedTogether && environment.done()[0] == 0 && environment.episodes(0) == 2);
+    }
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+
+    return (testsPassed == totalTests) ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+#include <chrono>
+#include <iostream>
+#include "../src/frame_pacer.hpp"
+
+using namespace std::chrono_literals;
+
+/// @brief Simulated time: sleeps advance it by the slice plus an overshoot, spins by a microsecond
+/// @details Keeps the tests independent of the machine's load and timer resolution.
+struct SimulatedClock {
+    using duration = std::chrono::steady_clock::duration;
+    using time_point = std::chrono::steady_clock::time_point;
+
+    struct State {
+        time_point now;
+        /// @brief Added to every sleep, like a coarse system timer
+        duration overshoot{};
+        duration slept{};
+        duration spun{};
+    };
+
+    time_point now() const { return state->now; }
+    void sleep(duration time) const {
+        state->now += time + state->overshoot;
+        state->slept += time + state->overshoot;
+    }
+    void yield() const {
+        state->now += 1us;
+        state->spun += 1us;
+    }
+
+    State *state;
+};
+
+using SimulatedPacer = BasicFramePacer<SimulatedClock>;
+
+/// @brief Render and present frames as soon as the pacer releases them
+/// @param frameCost Time from release to the end of the swap call
+/// @param vblank Refresh period the swap waits for, or zero if the swap interval is ignored
+/// @return Simulated time the frames took, in milliseconds
+double runFrames(SimulatedPacer &pacer, SimulatedClock::State &state, int frames,
+                 SimulatedClock::duration frameCost = 0us, SimulatedClock::duration vblank = 0us) {
+    auto start = state.now;
+    for (int frame = 0; frame < frames; frame++) {
+        while (!pacer.wait(1ms)) {
+        }
+        state.now += frameCost;
+        if (vblank > 0us) {
+            auto sinceEpoch = state.now.time_since_epoch();
+            state.now += (vblank - sinceEpoch % vblank) % vblank;
+        }
+        pacer.presented(state.now);
+    }
+    return std::chrono::duration<double, std::milli>(state.now - start).count();
+}
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running Frame Pacer Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    // Test 1: Without a target every frame is released at once
+    {
+        SimulatedClock::State state;
+        SimulatedPacer pacer(SimulatedClock{&state});
+        pacer.configure(0.0, false);
+        check("Test 1: Uncapped frames are never held",
+              runFrames(pacer, state, 1000) == 0.0 && pacer.presentedFrames() == 1000);
+    }
+
+    // Test 2: A cap holds frames to its rate, mostly sleeping rather than spinning, and a coarse
+    // timer leads to more spinning instead of missed frames
+    {
+        SimulatedClock::State state;
+        SimulatedPacer pacer(SimulatedClock{&state});
+        pacer.configure(100.0, false);
+        double wall = runFrames(pacer, state, 40, 2ms);
+        bool paced = wall > 389.0 && wall < 401.0 && state.spun < state.slept / 10;
+
+        SimulatedClock::State coarse;
+        coarse.overshoot = 2ms;
+        SimulatedPacer coarsePacer(SimulatedClock{&coarse});
+        coarsePacer.configure(100.0, false);
+        double coarseWall = runFrames(coarsePacer, coarse, 40, 2ms);
+        std::cout << "  40 frames at 100 fps took " << wall << " ms, " << coarseWall
+                  << " ms with 2 ms sleep overshoot\n";
+        check("Test 2: Capped frames keep the period without a busy loop",
+              paced && coarseWall < 401.0 && coarsePacer.missedFrames() == 0);
+    }
+
+    // Test 3: A late frame is counted and the cadence skips ahead instead of bursting
+    {
+        SimulatedClock::State state;
+        SimulatedPacer pacer(SimulatedClock{&state});
+        pacer.configure(100.0, false);
+        runFrames(pacer, state, 2);
+        long long missedBefore = pacer.missedFrames();
+        state.now += 35ms;
+        pacer.presented(state.now);
+        bool missed = pacer.missedFrames() == missedBefore + 1;
+        // Catching up would release the next frames at once
+        check("Test 3: Late frames are missed, not caught up",
+              missed && runFrames(pacer, state, 3) > 20.0);
+    }
+
+    // Test 4: Vsync that does not hold swaps back falls back to the pacer's own cadence
+    {
+        SimulatedClock::State state;
+        SimulatedPacer pacer(SimulatedClock{&state});
+        pacer.configure(100.0, true);
+        runFrames(pacer, state, SimulatedPacer::VSYNC_CHECK_FRAMES + 1, 1ms);
+        bool fellBack = !pacer.vsync() && pacer.vsyncFellBack();
+        double wall = runFrames(pacer, state, 20, 1ms);
+        check("Test 4: Unhonored vsync falls back to sleeping",
+              fellBack && wall > 195.0 && wall < 202.0);
+    }
+
+    // Test 5: Slow startup frames do not hide an unhonored swap interval
+    {
+        SimulatedClock::State state;
+        SimulatedPacer pacer(SimulatedClock{&state});
+        pacer.configure(100.0, true);
+        runFrames(pacer, state, SimulatedPacer::VSYNC_CHECK_FRAMES, 40ms);
+        bool keptDuringStartup = pacer.vsync();
+        runFrames(pacer, state, SimulatedPacer::VSYNC_CHECK_FRAMES, 1ms);
+        check("Test 5: Vsync is checked after startup too",
+              keptDuringStartup && !pacer.vsync() && pacer.vsyncFellBack());
+    }
+
+    // Test 6: Honored vsync is kept and presents land on every vertical blank
+    {
+        SimulatedClock::State state;
+        SimulatedPacer pacer(SimulatedClock{&state});
+        pacer.configure(100.0, true);
+        double wall = runFrames(pacer, state, 200, 2ms, 10ms);
+        check("Test 6: Honored vsync keeps the refresh rate",
+              pacer.vsync() && pacer.missedFrames() == 0 && wall > 1990.0 && wall < 2001.0);
+    }
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+    return testsPassed == totalTests ? 0 : 1;
+}
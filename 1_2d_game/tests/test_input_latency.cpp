@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include "../src/game.hpp"
+#include "../src/input_latency.hpp"
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running Input Latency Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    using Clock = InputLatency::Clock;
+    using std::chrono::milliseconds;
+    auto near = [](double value, double expected) { return std::abs(value - expected) < 0.05; };
+
+    // Test 1: An event is measured from its arrival to the first present after it was sampled
+    {
+        FrameStats frameStats;
+        InputLatency latency;
+        Clock::time_point start = Clock::now();
+        latency.inputEvent(start);
+        bool nothingYet = latency.presented(start + milliseconds(2), frameStats) == 0;
+        latency.sampled(start + milliseconds(10), frameStats);
+        std::size_t recorded = latency.presented(start + milliseconds(25), frameStats);
+        bool once = latency.presented(start + milliseconds(41), frameStats) == 0;
+        check("Test 1: Latency spans event to present",
+              nothingYet && recorded == 1 && once && frameStats.inputLatency.count() == 1 &&
+                  near(frameStats.inputLatency.maxMilliseconds(), 25.0) &&
+                  near(frameStats.inputWait.maxMilliseconds(), 10.0));
+    }
+
+    // Test 2: Events beyond the fixed capacity are counted instead of stored
+    {
+        FrameStats frameStats;
+        InputLatency latency;
+        Clock::time_point start = Clock::now();
+        for (std::size_t i = 0; i < InputLatency::MAX_EVENTS + 3; i++) {
+            latency.inputEvent(start);
+        }
+        latency.sampled(start, frameStats);
+        check("Test 2: Overflowing events are dropped",
+              latency.dropped() == 3 &&
+                  latency.presented(start, frameStats) == InputLatency::MAX_EVENTS);
+    }
+
+    // Test 3: A late latch only binds the events it shows; the rest wait for the tick
+    {
+        FrameStats frameStats;
+        InputLatency latency;
+        Clock::time_point start = Clock::now();
+        latency.inputEvent(start, true);
+        latency.inputEvent(start + milliseconds(1), false);
+        latency.lateLatched(start + milliseconds(4), frameStats);
+        bool movementOnly = latency.presented(start + milliseconds(8), frameStats) == 1;
+        latency.sampled(start + milliseconds(16), frameStats);
+        bool attackAfterTick = latency.presented(start + milliseconds(24), frameStats) == 1;
+        check("Test 3: Late latch leaves other events to the tick",
+              movementOnly && attackAfterTick &&
+                  near(frameStats.inputWait.maxMilliseconds(), 15.0) &&
+                  near(frameStats.inputLatency.maxMilliseconds(), 23.0));
+    }
+
+    // Test 4: The late-latched position is on the way to where the next tick moves the player
+    {
+        GameState gameState(10, 10);
+        gameState.playerObject.currentPosition = glm::vec2(0.0f, -0.5f);
+        TickInput input;
+        input.press(InputButton::Up);
+        input.press(InputButton::Right);
+        glm::vec2 latched = latchedPlayerPosition(gameState, input, TICK_MS / 2);
+        glm::vec2 full = latchedPlayerPosition(gameState, input, TICK_MS);
+        glm::vec2 unchanged = latchedPlayerPosition(gameState, input, 0);
+        applyInput(gameState, input);
+        glm::vec2 simulated = gameState.playerObject.currentPosition;
+        check("Test 4: Late latch agrees with the simulation",
+              full == simulated && unchanged == glm::vec2(0.0f, -0.5f) &&
+                  glm::length(latched - (unchanged + simulated) * 0.5f) < 1e-6f);
+    }
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../src/input_queue.hpp"
+
+/// @brief Per-tick inputs of a timeline whose events are queued in batches
+/// @param queueEvery Queue the events of this many ticks at once, ahead of the consumer
+std::vector<std::uint8_t> drainTicks(const std::vector<InputEvent> &events, int ticks,
+                                     int queueEvery) {
+    InputEventQueue queue;
+    InputTimeline timeline;
+    std::vector<std::uint8_t> inputs;
+    std::size_t next = 0;
+    for (int tick = 0; tick < ticks; tick++) {
+        int tickEnd = (tick + 1) * TICK_MS;
+        if (tick % queueEvery == 0) {
+            int arrivedBy = tickEnd + (queueEvery - 1) * TICK_MS;
+            while (next < events.size() && events[next].timeMs <= arrivedBy) {
+                queue.push(events[next++]);
+            }
+        }
+        inputs.push_back(timeline.advance(queue, tickEnd).buttons);
+    }
+    return inputs;
+}
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running Input Queue Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    // Test 1: The queue is FIFO and refuses items when full
+    {
+        SpscQueue<int, 4> queue;
+        bool pushed = queue.push(1) && queue.push(2) && queue.push(3) && queue.push(4);
+        bool full = !queue.push(5);
+        bool fifo = *queue.front() == 1 && queue.pop() && *queue.front() == 2 && queue.push(5);
+        int drained = 0;
+        while (queue.front() != nullptr) {
+            drained = *queue.front();
+            queue.pop();
+        }
+        check("Test 1: Queue is FIFO and bounded",
+              pushed && full && fifo && drained == 5 && queue.empty() && !queue.pop());
+    }
+
+    // Test 2: Items cross threads in order without loss
+    {
+        constexpr int COUNT = 200000;
+        SpscQueue<int, 64> queue;
+        std::thread producer([&] {
+            for (int i = 0; i < COUNT; i++) {
+                while (!queue.push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        bool ordered = true;
+        for (int expected = 0; expected < COUNT;) {
+            const int *item = queue.front();
+            if (item == nullptr) {
+                std::this_thread::yield();
+                continue;
+            }
+            ordered = ordered && *item == expected;
+            queue.pop();
+            expected++;
+        }
+        producer.join();
+        check("Test 2: Items cross threads in order", ordered && queue.empty());
+    }
+
+    auto bits = [](InputButton button) { return static_cast<std::uint8_t>(button); };
+    std::vector<InputEvent> events = {
+        {5, InputButton::Attack, true},  // A tap shorter than a tick...
+        {9, InputButton::Attack, false}, // ...still fires in tick 0
+        {20, InputButton::Left, true},   // Held through ticks 1 and 2, released in tick 3
+        {50, InputButton::Left, false},
+        {64, InputButton::Up, true}, // Exactly at the end of tick 3
+    };
+
+    // Test 3: Events apply at the tick their time falls in, taps included
+    std::vector<std::uint8_t> inputs = drainTicks(events, 6, 1);
+    check("Test 3: Events apply at their tick",
+          inputs[0] == bits(InputButton::Attack) && inputs[1] == bits(InputButton::Left) &&
+              inputs[2] == bits(InputButton::Left) &&
+              inputs[3] == (bits(InputButton::Left) | bits(InputButton::Up)) &&
+              inputs[4] == bits(InputButton::Up) && inputs[5] == bits(InputButton::Up));
+
+    // Test 4: The ticks only depend on the event times, not on how far ahead events are queued
+    check("Test 4: Queueing ahead gives the same ticks",
+          drainTicks(events, 6, 3) == inputs && drainTicks(events, 6, 6) == inputs);
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include "../src/program_cache.hpp"
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running Program Cache Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    // Test 1: The key changes with any source or driver string, including where parts split
+    {
+        std::uint64_t key = programCacheKey({"vertex", "fragment", "Mesa", "llvmpipe", "4.5"});
+        bool stable = key == programCacheKey({"vertex", "fragment", "Mesa", "llvmpipe", "4.5"});
+        bool sources = key != programCacheKey({"vertex", "fragment2", "Mesa", "llvmpipe", "4.5"});
+        bool driver = key != programCacheKey({"vertex", "fragment", "Mesa", "llvmpipe", "4.6"});
+        bool split = key != programCacheKey({"vertexf", "ragment", "Mesa", "llvmpipe", "4.5"});
+        check("Test 1: Key covers sources and driver", stable && sources && driver && split);
+    }
+
+    const std::string path = "test_program_cache.bin";
+    ProgramBinary binary;
+    binary.format = 0x8B87;
+    for (int i = 0; i < 1000; i++) {
+        binary.data.push_back(static_cast<std::uint8_t>(i * 7));
+    }
+
+    // Test 2: A binary reads back exactly under its key
+    {
+        ProgramBinary loaded;
+        bool written = writeProgramBinary(path, 42, binary);
+        bool read = readProgramBinary(path, 42, loaded);
+        check("Test 2: Binary round trip",
+              written && read && loaded.format == binary.format && loaded.data == binary.data);
+    }
+
+    // Test 3: Another key misses, so a changed shader or driver compiles from source
+    {
+        ProgramBinary loaded;
+        check("Test 3: Key mismatch misses the cache", !readProgramBinary(path, 43, loaded));
+    }
+
+    // Test 4: Truncated and missing files miss the cache
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream(path, std::ios::binary) << bytes.substr(0, bytes.size() - 1);
+        ProgramBinary loaded;
+        bool truncated = !readProgramBinary(path, 42, loaded);
+        std::remove(path.c_str());
+        bool missing = !readProgramBinary(path, 42, loaded);
+        check("Test 4: Damaged or missing files miss the cache", truncated && missing);
+    }
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "../src/game.hpp"
+#include "../src/input_replay.hpp"
+
+constexpr int TICKS = 600;
+constexpr int HASH_INTERVAL = 30;
+
+/// @brief Scripted input: wander around while holding attack, with runs of varying length
+TickInput scriptedInput(int tick) {
+    TickInput input;
+    const InputButton directions[] = {InputButton::Up, InputButton::Left, InputButton::Down,
+                                      InputButton::Right};
+    input.press(directions[(tick / 37) % 4]);
+    if ((tick / 11) % 3 != 0)
+        input.press(InputButton::Attack);
+    return input;
+}
+
+/// @brief Replay a recording from a fresh game
+/// @param nudge Moved the player by this much first, to make the replay diverge
+/// @return Number of ticks replayed before the end or the first mismatch
+int replayRecording(const std::string &path, InputReplay &replay, float nudge) {
+    GameState gameState(100, 500);
+    gameState.playerObject.move(glm::vec2(nudge, 0.0f));
+    if (!replay.open(path))
+        return -1;
+    int tick = 0;
+    TickInput input;
+    while (replay.next(input)) {
+        advanceTick(gameState, input, tick);
+        tick++;
+        if (!replay.afterTick(tick, gameState))
+            break;
+    }
+    return tick;
+}
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running Input Replay Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    // Boss::update logs every spawn; keep the test output readable
+    std::cout.setstate(std::ios::failbit);
+    const std::string path = "test_replay.bhrp";
+    {
+        GameState gameState(100, 500);
+        InputRecorder recorder;
+        recorder.open(path, HASH_INTERVAL);
+        for (int tick = 0; tick < TICKS; tick++) {
+            TickInput input = scriptedInput(tick);
+            recorder.record(input);
+            advanceTick(gameState, input, tick);
+            recorder.afterTick(tick + 1, gameState);
+        }
+    }
+    InputReplay replay;
+    int replayedTicks = replayRecording(path, replay, 0.0f);
+    InputReplay diverged;
+    int divergedTicks = replayRecording(path, diverged, 0.01f);
+    InputReplay missing;
+    bool missingOpened = missing.open("missing.bhrp");
+    std::cout.clear();
+
+    // Test 1: Replaying the inputs reproduces every recorded state
+    check("Test 1: Replay reproduces the recorded states",
+          replayedTicks == TICKS && replay.error().empty() &&
+              replay.hashesChecked() == TICKS / HASH_INTERVAL);
+
+    // Test 2: A different starting state is caught at the first hash
+    check("Test 2: Divergence is detected at the first hash",
+          divergedTicks == HASH_INTERVAL && !diverged.error().empty());
+
+    // Test 3: Missing files are rejected
+    check("Test 3: Missing recording is rejected", !missingOpened && !missing.error().empty());
+
+    std::remove(path.c_str());
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+
+    return (testsPassed == totalTests) ? 0 : 1;
+}
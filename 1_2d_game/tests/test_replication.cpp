@@ -0,0 +1,196 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "../src/replication.hpp"
+#include "../src/scenario.hpp"
+
+/// @brief Scripted input: strafe while firing
+TickInput scriptedInput(int tick) {
+    TickInput input;
+    input.press((tick / 20) % 2 == 0 ? InputButton::Left : InputButton::Right);
+    input.press(InputButton::Attack);
+    return input;
+}
+
+/// @brief Count the bullets of the server with no close counterpart on the client, and vice versa
+/// @details Both sides keep bullets in spawn order, so one merge pass pairs them up.
+template <typename Bullet>
+int countMismatches(const std::vector<Bullet> &server, const std::vector<Bullet> &client,
+                    float tolerance) {
+    int mismatches = 0;
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < server.size() && j < client.size()) {
+        if (glm::length(server[i].currentPosition - client[j].currentPosition) <= tolerance) {
+            i++;
+            j++;
+        } else if (server[i].initialTime <= client[j].initialTime) {
+            i++;
+            mismatches++;
+        } else {
+            j++;
+            mismatches++;
+        }
+    }
+    return mismatches + static_cast<int>(server.size() - i + client.size() - j);
+}
+
+/// @brief Run the game with a server and spectators, polling every client after each tick
+/// @param skipPolls Called with the client index and tick; returning true leaves the client alone
+template <typename SkipPolls>
+int runServed(GameState &gameState, ReplicationServer &server,
+              std::vector<ReplicationClient> &clients, int firstTick, int ticks,
+              SkipPolls skipPolls) {
+    int tick = firstTick;
+    for (; tick < firstTick + ticks; tick++) {
+        advanceTick(gameState, scriptedInput(tick), tick);
+        server.publish(tick + 1, tickTime(tick), gameState);
+        for (std::size_t i = 0; i < clients.size(); i++) {
+            if (!skipPolls(i, tick))
+                clients[i].poll();
+        }
+    }
+    return tick;
+}
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running Replication Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    // Test 1: Wire values round-trip, quantized ones within their step
+    {
+        std::vector<std::uint8_t> bytes;
+        ByteWriter writer(bytes);
+        writer.varint(300);
+        writer.signedVarint(-5);
+        writer.u32(0xDEADBEEF);
+        writer.f32(0.125f);
+        writer.position(glm::vec2(0.3f, -0.7f));
+        writer.u16(replication::quantizeAngle(glm::normalize(glm::vec2(-1.0f, -2.0f))));
+        ByteReader reader(bytes.data(), bytes.size());
+        bool exact = reader.varint() == 300 && reader.signedVarint() == -5 &&
+                     reader.u32() == 0xDEADBEEF && reader.f32() == 0.125f;
+        glm::vec2 position = reader.position();
+        glm::vec2 direction = replication::dequantizeAngle(reader.u16());
+        bool quantized = glm::length(position - glm::vec2(0.3f, -0.7f)) < 1e-4f &&
+                         glm::length(direction - glm::normalize(glm::vec2(-1.0f, -2.0f))) < 1e-4f;
+        reader.u8();
+        check("Test 1: Wire values round-trip", exact && quantized && !reader.ok());
+    }
+
+    // Boss::update logs every spawn; keep the test output readable
+    std::cout.setstate(std::ios::failbit);
+    ReplicationServer server;
+    bool opened = server.open(0);
+    std::uint16_t port = server.localAddress().port;
+
+    // Test 2: A spectator converges on the server's game
+    GameState gameState(1000, 500);
+    populateBulletField(gameState, 3000, 100, 11);
+    std::vector<ReplicationClient> clients(2);
+    bool connected = opened && clients[0].connect(port) && clients[1].connect(port);
+    // The first publish picks up the HELLOs, the second sends the full snapshot
+    int tick = runServed(gameState, server, clients, 0, 300,
+                         [](std::size_t, int) { return false; });
+    const GameState &replicated = clients[0].state();
+    int enemyMismatches =
+        countMismatches(gameState.enemyBulletObjects, replicated.enemyBulletObjects, 2e-3f);
+    int playerMismatches =
+        countMismatches(gameState.playerBulletObjects, replicated.playerBulletObjects, 2e-3f);
+    bool converged = connected && clients[0].tick() == tick &&
+                     replicated.health == gameState.health &&
+                     replicated.bossHealth == gameState.bossHealth && enemyMismatches <= 4 &&
+                     playerMismatches <= 4 && clients[0].fullSnapshots() == 1;
+
+    // Test 3: A spectator that stops reading falls back to a full snapshot and catches up
+    tick = runServed(gameState, server, clients, tick, 400,
+                     [](std::size_t client, int t) { return client == 1 && t < 500; });
+    const GameState &stalled = clients[1].state();
+    bool caughtUp = clients[1].tick() == tick && clients[1].fullSnapshots() >= 2 &&
+                    countMismatches(gameState.enemyBulletObjects, stalled.enemyBulletObjects,
+                                    2e-3f) <= 4;
+
+    // Test 4: A spectator that leaves is forgotten
+    clients[1].disconnect();
+    tick = runServed(gameState, server, clients, tick, 4,
+                     [](std::size_t client, int) { return client == 1; });
+    bool forgotten = server.clientCount() == 1;
+    std::cout.clear();
+    if (!opened)
+        std::cout << "  " << server.error() << '\n';
+    check("Test 2: Spectator converges on the server state", converged);
+    check("Test 3: Stalled spectator catches up", caughtUp);
+    check("Test 4: Disconnected spectator is dropped", forgotten);
+
+    // Test 5: Steady-state traffic does not grow with the number of live bullets
+    auto steadyBytes = [](int bullets) {
+        ReplicationServer server;
+        server.open(0);
+        std::vector<ReplicationClient> clients(1);
+        clients[0].connect(server.localAddress().port);
+        GameState gameState(1000, 500);
+        populateBulletField(gameState, bullets, 0, 3);
+        // Bullets drifting slowly stay in the field for the whole measurement
+        int tick = runServed(gameState, server, clients, 0, 60,
+                             [](std::size_t, int) { return false; });
+        std::uint64_t before = server.bytesSent();
+        runServed(gameState, server, clients, tick, 240, [](std::size_t, int) { return false; });
+        return server.bytesSent() - before;
+    };
+    std::cout.setstate(std::ios::failbit);
+    std::uint64_t small = steadyBytes(1000);
+    std::uint64_t large = steadyBytes(10000);
+    std::cout.clear();
+    std::cout << "  steady state: " << small << " bytes with 1k bullets, " << large
+              << " bytes with 10k bullets\n";
+    check("Test 5: Steady-state bandwidth is independent of bullet count",
+          small > 0 && large < small * 2 && large < 10000 * 12);
+
+    // Test 6: Two deltas from the same baseline, applied in one poll, still carry every despawn.
+    // Player bullets spawn in one delta and are removed inside the field in the next, as a
+    // gameplay rule removing bullets on a hit would.
+    {
+        std::cout.setstate(std::ios::failbit);
+        ReplicationServer server;
+        server.open(0);
+        ReplicationClient client;
+        client.connect(server.localAddress().port);
+        GameState gameState(1000, 500);
+        TickInput attack;
+        attack.press(InputButton::Attack);
+        int ghosts = 0;
+        for (int tick = 0; tick < 400; tick++) {
+            std::erase_if(gameState.playerBulletObjects, [&](const PlayerBullet &bullet) {
+                return bullet.initialTime < tickTime(tick);
+            });
+            advanceTick(gameState, attack, tick);
+            server.publish(tick + 1, tickTime(tick), gameState);
+            // Poll after every second snapshot, before the server read the ack of the first
+            if (tick % 4 != 3)
+                continue;
+            client.poll();
+            ghosts += countMismatches(gameState.playerBulletObjects,
+                                      client.state().playerBulletObjects, 2e-3f);
+        }
+        std::cout.clear();
+        check("Test 6: Despawns reach spectators polling behind the acks",
+              client.tick() == 400 && ghosts == 0);
+    }
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+    return testsPassed == totalTests ? 0 : 1;
+}
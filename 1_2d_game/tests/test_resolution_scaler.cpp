@@ -0,0 +1,85 @@
+#include <cmath>
+#include <iostream>
+#include "../src/resolution_scaler.hpp"
+
+/// @brief Feed frames whose cost scales with the pixel count, plus a deterministic jitter
+/// @param fullCost Cost of a frame at scale 1, in milliseconds
+void runFrames(ResolutionScaler &scaler, double fullCost, int frames, double jitter = 0.0) {
+    for (int frame = 0; frame < frames; frame++) {
+        double scale = scaler.scale();
+        double noise = jitter * std::sin(frame * 0.7);
+        scaler.record(fullCost * scale * scale + noise);
+    }
+}
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running Resolution Scaler Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    // Test 1: Frames under budget keep the full resolution
+    {
+        ResolutionScaler scaler;
+        runFrames(scaler, 6.0, 500);
+        check("Test 1: Cheap frames stay at full scale",
+              scaler.scale() == 1.0f && scaler.changes() == 0);
+    }
+
+    // Test 2: Expensive frames drop to a fitting scale in one decision
+    {
+        ResolutionScaler scaler;
+        runFrames(scaler, 24.0, 60);
+        float scale = scaler.scale();
+        const ResolutionScaler::Decision &decision = scaler.lastDecision();
+        std::cout << "  24 ms frames settled at scale " << scale << "\n";
+        check("Test 2: Expensive frames scale down at once",
+              scaler.changes() == 1 && decision.from == 1.0f && decision.to == scale &&
+                  24.0 * scale * scale <= 12.0 && scale >= 0.65f);
+    }
+
+    // Test 3: The scale never leaves its bounds
+    {
+        ResolutionScaler scaler;
+        runFrames(scaler, 500.0, 300);
+        check("Test 3: Scale stops at the minimum", std::abs(scaler.scale() - 0.5f) < 1e-4f);
+    }
+
+    // Test 4: Once the load drops, the scale climbs back step by step
+    {
+        ResolutionScaler scaler;
+        runFrames(scaler, 30.0, 100);
+        int changesDown = scaler.changes();
+        float lowered = scaler.scale();
+        runFrames(scaler, 5.0, 1000);
+        check("Test 4: Cheap frames restore the full scale",
+              lowered < 0.75f && std::abs(scaler.scale() - 1.0f) < 1e-4f &&
+                  scaler.changes() - changesDown >= 3);
+    }
+
+    // Test 5: Noisy frames near the budget settle instead of flipping between two scales
+    {
+        ResolutionScaler scaler;
+        runFrames(scaler, 16.0, 200, 1.5);
+        int settledChanges = scaler.changes();
+        runFrames(scaler, 16.0, 2000, 1.5);
+        std::cout << "  Near-budget frames: " << settledChanges << " changes while settling, "
+                  << scaler.changes() - settledChanges << " afterwards\n";
+        check("Test 5: Hysteresis prevents oscillation", scaler.changes() == settledChanges);
+    }
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include "../src/input_replay.hpp"
+#include "../src/scenario.hpp"
+#include "../src/snapshot.hpp"
+
+constexpr int RING_SIZE = 16;
+constexpr int ROLLBACK_TICKS = 8;
+
+/// @brief Scripted input: strafe while firing
+TickInput scriptedInput(int tick) {
+    TickInput input;
+    input.press((tick / 20) % 2 == 0 ? InputButton::Left : InputButton::Right);
+    input.press(InputButton::Attack);
+    return input;
+}
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running Snapshot Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    // Boss::update logs every spawn; keep the test output readable
+    std::cout.setstate(std::ios::failbit);
+    GameState gameState(100, 500);
+    populateBulletField(gameState, 2000, 200, 7);
+    SnapshotRing ring(RING_SIZE, 4096);
+    int tick = 0;
+    ring.save(tick, gameState);
+    for (; tick < 100; tick++) {
+        advanceTick(gameState, scriptedInput(tick), tick);
+        ring.save(tick + 1, gameState);
+    }
+    std::uint64_t forwardHash = hashGameState(gameState);
+
+    // Roll back and resimulate the same inputs
+    int rollbackTick = tick - ROLLBACK_TICKS;
+    bool restored = ring.restore(rollbackTick, gameState);
+    const EnemyBullet *storage = gameState.enemyBulletObjects.data();
+    ring.restore(tick, gameState);
+    bool storageReused = gameState.enemyBulletObjects.data() == storage;
+    ring.restore(rollbackTick, gameState);
+    for (int t = rollbackTick; t < tick; t++) {
+        advanceTick(gameState, scriptedInput(t), t);
+        ring.save(t + 1, gameState);
+    }
+    std::uint64_t resimulatedHash = hashGameState(gameState);
+
+    // Roll back again and resimulate with a corrected input
+    ring.restore(rollbackTick, gameState);
+    for (int t = rollbackTick; t < tick; t++) {
+        TickInput input = scriptedInput(t);
+        input.press(InputButton::Up);
+        advanceTick(gameState, input, t);
+    }
+    std::uint64_t correctedHash = hashGameState(gameState);
+    std::cout.clear();
+
+    // Test 1: Restoring and resimulating the same inputs reproduces the same state
+    check("Test 1: Rollback and resimulation is deterministic",
+          restored && resimulatedHash == forwardHash);
+
+    // Test 2: Different inputs after the rollback point lead to a different state
+    check("Test 2: Corrected input changes the resimulated state", correctedHash != forwardHash);
+
+    // Test 3: Only the last RING_SIZE ticks are kept
+    check("Test 3: Ring keeps only the newest ticks",
+          ring.contains(tick) && ring.contains(tick - RING_SIZE + 1) &&
+              !ring.contains(tick - RING_SIZE) && !ring.restore(0, gameState) &&
+              ring.newestTick() == tick);
+
+    // Test 4: Restoring into a game with enough capacity copies in place
+    check("Test 4: Restore reuses the bullet storage", storageReused);
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+
+    return (testsPassed == totalTests) ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+#include <iostream>
+#include "../src/render.hpp"
+#include "../src/render_queue.hpp"
+#include "../src/soft_raster.hpp"
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    const std::uint32_t BLACK = packRgba(0, 0, 0);
+    const std::uint32_t WHITE = packRgba(255, 255, 255);
+    const std::uint32_t RED = packRgba(255, 0, 0);
+    const std::uint32_t GREEN = packRgba(0, 255, 0);
+    const std::uint32_t BLUE = packRgba(0, 0, 255);
+
+    std::cout << "Running Software Rasterizer Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    // By default world [-1, 1] maps onto the whole framebuffer with row 0 at the top
+
+    // Test 1: Clear color fills the whole framebuffer
+    {
+        SoftRasterizer rasterizer(100, 100, 4);
+        rasterizer.clear(glm::fvec3(1.0f));
+        rasterizer.flush();
+        bool allWhite = true;
+        for (std::uint32_t pixel : rasterizer.pixels()) {
+            allWhite = allWhite && pixel == WHITE;
+        }
+        check("Test 1: Clear fills every tile", allWhite);
+    }
+
+    // Test 2: Circle covers its center but not the corners of its bounding box
+    {
+        SoftRasterizer rasterizer(100, 100, 4);
+        rasterizer.drawCircle(glm::fvec2(0.0f, 0.0f), 0.5f, 10, glm::fvec3(1.0f, 0.0f, 0.0f));
+        rasterizer.flush();
+        check("Test 2: Circle covers center and edge",
+              rasterizer.pixel(50, 50) == RED && rasterizer.pixel(26, 50) == RED &&
+                  rasterizer.pixel(50, 73) == RED);
+        check("Test 3: Circle leaves bounding box corners empty",
+              rasterizer.pixel(27, 27) == BLACK && rasterizer.pixel(72, 72) == BLACK &&
+                  rasterizer.pixel(23, 50) == BLACK);
+    }
+
+    // Test 4: Rect spanning several tiles is filled exactly
+    {
+        SoftRasterizer rasterizer(200, 200, 4);
+        rasterizer.drawRect(glm::fvec2(0.0f, 0.0f), 1.0f, glm::fvec3(0.0f, 1.0f, 0.0f));
+        rasterizer.flush();
+        bool inside = rasterizer.pixel(50, 50) == GREEN && rasterizer.pixel(149, 149) == GREEN &&
+                      rasterizer.pixel(100, 100) == GREEN;
+        bool outside = rasterizer.pixel(49, 100) == BLACK && rasterizer.pixel(150, 100) == BLACK &&
+                       rasterizer.pixel(100, 49) == BLACK && rasterizer.pixel(100, 150) == BLACK;
+        check("Test 4: Rect across tile borders", inside && outside);
+    }
+
+    // Test 5: Triangle points up (+y in world is toward row 0)
+    {
+        SoftRasterizer rasterizer(100, 100, 1);
+        rasterizer.drawTriangle(glm::fvec2(0.0f, 0.0f), 1.0f, glm::fvec3(1.0f));
+        rasterizer.flush();
+        check("Test 5: Triangle apex at top, base at bottom",
+              rasterizer.pixel(50, 27) == WHITE && rasterizer.pixel(30, 27) == BLACK &&
+                  rasterizer.pixel(27, 73) == WHITE && rasterizer.pixel(72, 73) == WHITE);
+    }
+
+    // Test 6: Later shapes overwrite earlier ones, and the camera offset moves shapes
+    {
+        SoftRasterizer rasterizer(100, 100, 4);
+        rasterizer.setViewProjection(makeViewProjection(glm::vec2(0.5f, 0.0f)));
+        rasterizer.drawRect(glm::fvec2(0.5f, 0.0f), 0.4f, glm::fvec3(1.0f, 0.0f, 0.0f));
+        rasterizer.drawRect(glm::fvec2(0.5f, 0.0f), 0.2f, glm::fvec3(0.0f, 1.0f, 0.0f));
+        rasterizer.flush();
+        check("Test 6: Submission order and camera transform",
+              rasterizer.pixel(50, 50) == GREEN && rasterizer.pixel(42, 50) == RED &&
+                  rasterizer.pixel(75, 50) == BLACK);
+    }
+
+    // Test 7: Render queue executes through the rasterizer and frames do not leak shapes
+    {
+        SoftRasterizer rasterizer(100, 100, 4);
+        RenderQueue queue;
+        queue.drawSdfCircle(glm::vec2(0.0f, 0.0f), 0.2f, 10, glm::vec3(1.0f, 0.0f, 0.0f),
+                            Layer::Boss);
+        queue.sort();
+        executeRenderQueue(queue, rasterizer);
+        rasterizer.flush();
+        bool first = rasterizer.pixel(50, 50) == RED;
+        rasterizer.flush();
+        check("Test 7: Render queue path and per-frame reset",
+              first && rasterizer.pixel(50, 50) == BLACK);
+    }
+
+    // Test 8: Sorting draws layers in order, whatever the submission order
+    {
+        SoftRasterizer rasterizer(100, 100, 4);
+        RenderQueue queue;
+        queue.drawTriangle(glm::vec2(0.0f, 0.0f), 0.2f, glm::vec3(0.0f, 0.0f, 1.0f), Layer::Player);
+        queue.drawSdfCircle(glm::vec2(0.0f, 0.0f), 0.4f, 10, glm::vec3(1.0f, 0.0f, 0.0f),
+                            Layer::Boss);
+        queue.drawRect(glm::vec2(0.0f, 0.0f), 1.0f, glm::vec3(0.0f, 1.0f, 0.0f),
+                       Layer::PlayerBullets);
+        queue.sort();
+        executeRenderQueue(queue, rasterizer);
+        rasterizer.flush();
+        check("Test 8: Sorted queue draws higher layers on top",
+              rasterizer.pixel(50, 50) == BLUE && rasterizer.pixel(58, 50) == RED &&
+                  rasterizer.pixel(72, 50) == GREEN);
+    }
+
+    // Test 9: Within a layer, interleaved primitives are grouped into batches
+    {
+        RenderQueue queue;
+        queue.drawSdfCircle(glm::vec2(0.0f, 0.0f), 0.1f, 10, glm::vec3(1.0f), Layer::EnemyBullets);
+        queue.drawRect(glm::vec2(0.0f, 0.0f), 0.1f, glm::vec3(1.0f), Layer::EnemyBullets);
+        queue.drawSdfCircle(glm::vec2(0.5f, 0.0f), 0.1f, 10, glm::vec3(1.0f), Layer::EnemyBullets);
+        queue.sort();
+        const auto &commands = queue.commands();
+        check("Test 9: Interleaved circle, rect, circle sort into one circle batch",
+              commands[0].primitive == Primitive::Rect &&
+                  commands[1].primitive == Primitive::SdfCircle &&
+                  commands[2].primitive == Primitive::SdfCircle && commands[2].center.x == 0.5f);
+    }
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+
+    return (testsPassed == totalTests) ? 0 : 1;
+}
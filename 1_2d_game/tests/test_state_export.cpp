@@ -0,0 +1,111 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "../src/scenario.hpp"
+#include "../src/state_export.hpp"
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running State Export Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    const std::string name = "/cs451_test_state_export";
+    constexpr std::uint32_t SLOTS = 4;
+    constexpr std::uint32_t MAX_BULLETS = 1000;
+
+    // Test 1: A published tick reads back unchanged
+    {
+        StateExporter exporter;
+        bool opened = exporter.open(name, SLOTS, MAX_BULLETS);
+        StateReader reader;
+        bool attached = opened && reader.attach(name);
+        bool emptyBefore = attached && reader.latestTick() == -1;
+
+        GameState gameState(7, 42);
+        populateBulletField(gameState, 300, 30, 5);
+        if (opened)
+            exporter.publish(1, gameState);
+        SharedFrame frame;
+        bool read = attached && reader.readLatest(frame);
+        bool matches = read && frame.tick == 1 && frame.health == 7 && frame.bossHealth == 42 &&
+                       frame.playerY == gameState.playerObject.currentPosition.y &&
+                       frame.enemyBullets.size() == 300 && frame.playerBullets.size() == 30 &&
+                       frame.enemyBullets[17].x ==
+                           gameState.enemyBulletObjects[17].currentPosition.x &&
+                       frame.droppedBullets == 0;
+        if (!opened)
+            std::cout << "  " << exporter.error() << '\n';
+        check("Test 1: Published state reads back", emptyBefore && matches);
+
+        // Test 2: Only the last SLOTS ticks stay readable, and bullets beyond capacity are counted
+        populateBulletField(gameState, MAX_BULLETS, 0, 6);
+        for (int tick = 2; tick <= 10; tick++) {
+            exporter.publish(tick, gameState);
+        }
+        SharedFrame latest;
+        check("Test 2: Ring keeps the newest ticks and counts dropped bullets",
+              attached && reader.latestTick() == 10 && !reader.read(6, frame) &&
+                  reader.read(7, frame) && reader.readLatest(latest) && latest.tick == 10 &&
+                  latest.enemyBullets.size() == MAX_BULLETS && latest.droppedBullets == 300);
+    }
+
+    // Test 3: A reader racing the writer never sees a torn frame
+    {
+        StateExporter exporter;
+        exporter.open(name, 2, MAX_BULLETS);
+        StateReader reader;
+        reader.attach(name);
+
+        // Every field of tick t encodes t, so a mix of two ticks is detectable
+        std::atomic<bool> stop = false;
+        std::thread writer([&] {
+            GameState gameState(0, 0);
+            for (int tick = 1; !stop; tick++) {
+                auto value = static_cast<float>(tick);
+                gameState.health = tick;
+                gameState.playerObject.currentPosition = glm::vec2(value);
+                gameState.enemyBulletObjects.assign(
+                    static_cast<std::size_t>(tick % 500),
+                    EnemyBullet(glm::vec2(1.0f, 0.0f), glm::vec2(value), 0.0f, 0));
+                exporter.publish(tick, gameState);
+            }
+        });
+        int consistent = 0;
+        int torn = 0;
+        SharedFrame frame;
+        auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+        while (std::chrono::steady_clock::now() < end) {
+            if (!reader.readLatest(frame))
+                continue;
+            bool valid = frame.health == frame.tick && frame.playerX == frame.tick &&
+                         frame.enemyBullets.size() == static_cast<std::size_t>(frame.tick % 500);
+            for (const SharedBullet &bullet : frame.enemyBullets) {
+                valid = valid && bullet.x == frame.tick;
+            }
+            (valid ? consistent : torn)++;
+        }
+        stop = true;
+        writer.join();
+        std::cout << "  " << consistent << " consistent reads, " << torn << " torn\n";
+        check("Test 3: Seqlock rejects torn reads", torn == 0 && consistent > 0);
+    }
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+
+    return (testsPassed == totalTests) ? 0 : 1;
+}
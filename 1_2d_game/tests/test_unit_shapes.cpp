@@ -0,0 +1,70 @@
+#include <cmath>
+#include <iostream>
+#include <numbers>
+#include <vector>
+#include "../src/unit_shapes.hpp"
+
+int main() {
+    int testsPassed = 0;
+    int totalTests = 0;
+
+    std::cout << "Running Unit Shape Tests\n";
+    std::cout << "==================================\n";
+
+    auto check = [&](const char *name, bool result) {
+        totalTests++;
+        if (result) {
+            std::cout << "[PASS] " << name << "\n";
+            testsPassed++;
+        } else {
+            std::cout << "[FAIL] " << name << "\n";
+        }
+    };
+
+    UnitShapes shapes;
+    const glm::vec2 center(0.3f, -0.7f);
+    const float size = 0.03f;
+
+    // Test 1: A scaled unit circle has exactly the vertices emitCircleTriangles computes
+    {
+        const int segments = 10;
+        std::vector<glm::vec2> expected;
+        glm::vec2 previous(center.x + size, center.y);
+        for (int i = 1; i <= segments; i++) {
+            float angle = static_cast<float>(2.0f * std::numbers::pi * i / segments);
+            glm::vec2 next(center.x + size * std::cos(angle), center.y + size * std::sin(angle));
+            expected.insert(expected.end(), {center, previous, next});
+            previous = next;
+        }
+        std::vector<glm::vec2> vertices;
+        appendShape(vertices, shapes.circle(segments), center, size);
+        check("Test 1: Circle matches the immediate path", vertices == expected);
+    }
+
+    // Test 2: Rects and triangles match emitRect and emitTriangle
+    {
+        float half = size / 2.0f;
+        std::vector<glm::vec2> expected = {
+            {center.x - half, center.y + half}, {center.x - half, center.y - half},
+            {center.x + half, center.y - half}, {center.x - half, center.y + half},
+            {center.x + half, center.y - half}, {center.x + half, center.y + half},
+            {center.x, center.y + size / 2},    {center.x - size / 2, center.y - size / 2},
+            {center.x + size / 2, center.y - size / 2},
+        };
+        std::vector<glm::vec2> vertices;
+        appendShape(vertices, shapes.shape(Primitive::Rect, 0), center, size);
+        appendShape(vertices, shapes.shape(Primitive::Triangle, 0), center, size);
+        check("Test 2: Rect and triangle match the immediate path", vertices == expected);
+    }
+
+    // Test 3: SDF circles use their fallback circle, and each segment count is built once
+    {
+        const std::vector<glm::vec2> &sdf = shapes.shape(Primitive::SdfCircle, 16);
+        check("Test 3: SDF circles fall back to cached circles",
+              &sdf == &shapes.circle(16) && sdf.size() == 16 * 3 && shapes.circle(0).empty());
+    }
+
+    std::cout << "==================================\n";
+    std::cout << "Tests passed: " << testsPassed << "/" << totalTests << "\n";
+    return testsPassed == totalTests ? 0 : 1;
+}